@@ -0,0 +1,90 @@
+// compile_arena.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Slab arena owning the products of program compilation                     *
+ ******************************************************************************
+ */
+#include "compile_arena.h"
+#include "errnum.h"
+#include <stdlib.h>
+
+// Zarovnani alokaci v arene
+#define COMPILE_ARENA_ALIGN 8
+#define alignSize(size) (((size) + COMPILE_ARENA_ALIGN - 1) & ~((size_t) COMPILE_ARENA_ALIGN - 1))
+
+tCompileArena compileArena = { NULL, NULL };
+
+// Alokace z areny prekladu
+void *compileArenaAlloc(size_t size)
+{
+	tCompileBlock *block = compileArena.blocks;
+	void *memory;
+
+	size = alignSize(size);
+
+	// -------------- Novy blok, pokud se alokace nevejde do aktualniho ---------
+	if (block == NULL || block->size - block->used < size)
+	{
+		size_t blockSize = size > COMPILE_ARENA_BLOCK_SIZE ? size : COMPILE_ARENA_BLOCK_SIZE;
+
+		block = malloc(sizeof(tCompileBlock) + blockSize);
+		if (block == NULL)
+			return NULL;
+
+		block->size = blockSize;
+		block->used = 0;
+
+		// Velky blok se zaradi za aktualni, aby se nezahodil jeho zbytek
+		if (blockSize > COMPILE_ARENA_BLOCK_SIZE && compileArena.blocks != NULL)
+		{
+			block->next = compileArena.blocks->next;
+			compileArena.blocks->next = block;
+		}
+		else
+		{
+			block->next = compileArena.blocks;
+			compileArena.blocks = block;
+		}
+	}
+
+	memory = block->data + block->used;
+	block->used += size;
+	return memory;
+}
+
+// Registrace prostredku mimo arenu
+ecode compileArenaRegister(void *resource, void (*release)(void *))
+{
+	tCompileResource *item = compileArenaAlloc(sizeof(tCompileResource));
+	if (item == NULL)
+		return ERR_MEMORY;
+
+	item->resource = resource;
+	item->release = release;
+	item->next = compileArena.resources;
+	compileArena.resources = item;
+	return ERR_OK;
+}
+
+// Uvolneni areny
+void compileArenaFree()
+{
+	tCompileBlock *next;
+
+	// -------------- Registrovane prostredky -----------------------------------
+	for (tCompileResource *item = compileArena.resources; item != NULL; item = item->next)
+		item->release(item->resource);
+
+	// -------------- Bloky areny -----------------------------------------------
+	while (compileArena.blocks != NULL)
+	{
+		next = compileArena.blocks->next;
+		free(compileArena.blocks);
+		compileArena.blocks = next;
+	}
+
+	compileArena.resources = NULL;
+}
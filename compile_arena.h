@@ -0,0 +1,69 @@
+// compile_arena.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Slab arena owning the products of program compilation                     *
+ ******************************************************************************
+ */
+
+#ifndef COMPILE_ARENA_H
+#define COMPILE_ARENA_H
+
+#include <stddef.h>
+#include "errnum.h"
+
+// Velikost jednoho bloku areny
+#ifndef COMPILE_ARENA_BLOCK_SIZE
+#define COMPILE_ARENA_BLOCK_SIZE (64 * 1024)
+#endif
+
+// Blok areny
+typedef struct t_compileBlock
+{
+	struct t_compileBlock *next;	// Dalsi blok
+	size_t size;					// Velikost dat bloku
+	size_t used;					// Pouzita cast dat bloku
+	char data[];					// Data bloku
+} tCompileBlock;
+
+// Prostredek mimo arenu, ktery se uvolni spolu s arenou
+typedef struct t_compileResource
+{
+	struct t_compileResource *next;
+	void *resource;					// Uvolnovany prostredek
+	void (*release)(void *);		// Funkce pro jeho uvolneni
+} tCompileResource;
+
+// Arena prekladu - instrukce, polozky seznamu instrukci, offsety operandu
+typedef struct
+{
+	tCompileBlock *blocks;			// Bloky, prvni je aktualni
+	tCompileResource *resources;	// Registrovane prostredky
+} tCompileArena;
+
+extern tCompileArena compileArena;
+
+/**
+ * Alokace pameti z areny prekladu, pamet se uvolnuje jen najednou
+ * funkci compileArenaFree
+ * @param  size Velikost v bajtech
+ * @return      Ukazatel na pamet nebo NULL pri nedostatku pameti
+ */
+void *compileArenaAlloc(size_t size);
+
+/**
+ * Registrace prostredku alokovaneho mimo arenu, ktery se uvolni spolu s arenou
+ * @param  resource Uvolnovany prostredek
+ * @param  release  Funkce pro jeho uvolneni
+ * @return          ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+ecode compileArenaRegister(void *resource, void (*release)(void *));
+
+/**
+ * Uvolneni registrovanych prostredku a vsech bloku areny
+ */
+void compileArenaFree();
+
+#endif // COMPILE_ARENA_H
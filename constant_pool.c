@@ -0,0 +1,291 @@
+// constant_pool.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Shared pool of immutable literals used as instruction operands             *
+ ******************************************************************************
+ */
+#include "constant_pool.h"
+#include "compile_arena.h"
+#include "errnum.h"
+#include "libstring.h"
+#include "variable.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#if !defined(CONSTANT_POOL_USE_MALLOC) && (!defined(MAP_ANONYMOUS) || !defined(MAP_NORESERVE))
+#define CONSTANT_POOL_USE_MALLOC
+#endif
+
+#if defined(CONSTANT_POOL_USE_MALLOC) && defined(PARSER_LAZY_FUNCTIONS)
+#error "PARSER_LAZY_FUNCTIONS vyzaduje tabulku konstant rezervovanou funkci mmap"
+#endif
+
+#define CONSTANT_POOL_ALLOC_STEP 64
+#define CONSTANT_POOL_HASH_INIT 128
+
+tConstantPool constantPool = { NULL, 0, false, NULL, 0, 0, NULL, 0 };
+
+/**
+ * Rezervace pole hodnot funkci mmap, stranky se alokuji az pri zapisu
+ * @return true pokud se rezervace povedla
+ */
+static bool reserveValues()
+{
+#ifdef CONSTANT_POOL_USE_MALLOC
+	return false;
+#else
+	size_t pageSize = sysconf(_SC_PAGESIZE);
+	size_t reserve = (CONSTANT_POOL_RESERVE + pageSize - 1) & ~(pageSize - 1);
+
+	void *data = mmap(NULL, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (data == MAP_FAILED)
+		return false;
+
+	constantPool.values = data;
+	constantPool.capacity = reserve / sizeof(tVariable);
+	constantPool.mapped = true;
+	return true;
+#endif
+}
+
+/**
+ * Zvetseni pole hodnot. Rezervovane pole se nepresouva, pri jeho zaplneni
+ * se tabulka nezvetsi. Pole alokovane funkci malloc se zvetsuje realloc
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode growValues()
+{
+	if (constantPool.values == NULL && reserveValues())
+		return ERR_OK;
+#ifdef PARSER_LAZY_FUNCTIONS
+	// Presunuti pole by zneplatnilo ukazatele na hodnoty na zasobniku
+	return ERR_MEMORY;
+#else
+	if (constantPool.mapped)
+		return ERR_MEMORY;
+
+	int newCapacity = constantPool.capacity + CONSTANT_POOL_ALLOC_STEP;
+	tVariable *newValues = realloc(constantPool.values, newCapacity * sizeof(tVariable));
+	if (newValues == NULL)
+		return ERR_MEMORY;
+
+	constantPool.values = newValues;
+	constantPool.capacity = newCapacity;
+	return ERR_OK;
+#endif
+}
+
+/**
+ * Vypocet rozptylovaci funkce (FNV-1a) nad typem a hodnotou literalu
+ * @param  type Datovy typ literalu
+ * @param  data Hodnota literalu
+ * @return      Hash literalu
+ */
+static unsigned int constantHash(SemanticType type, void *data)
+{
+	unsigned int hash = 2166136261u ^ (unsigned int) type;
+	unsigned char *bytes = NULL;
+	int length = 0;
+
+	if (type == STRING)
+	{
+		bytes = (unsigned char *) ((String *) data)->data;
+		length = ((String *) data)->length;
+	}
+	else if (type == NUMERIC)
+	{
+		bytes = data;
+		length = sizeof(double);
+	}
+	else if (type == LOGICAL)
+	{
+		return hash ^ (*((bool *) data) ? 1 : 0);
+	}
+
+	for (int i = 0; i < length; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Porovnani literalu s konstantou v tabulce
+ * @return true pokud jsou hodnoty shodne
+ */
+static bool constantEquals(tVariable *value, SemanticType type, void *data)
+{
+	if (value->semantic != type)
+		return false;
+
+	switch (type)
+	{
+		case STRING:
+			return ((String *) value->value)->length == ((String *) data)->length &&
+			       memcmp(((String *) value->value)->data, ((String *) data)->data, ((String *) data)->length) == 0;
+		case NUMERIC:
+			return memcmp(value->value, data, sizeof(double)) == 0;
+		case LOGICAL:
+			return *((bool *) value->value) == *((bool *) data);
+		default:	// NIL, FUNCTION
+			return true;
+	}
+}
+
+/**
+ * Uvolneni hodnoty literalu
+ */
+static void freeConstantData(SemanticType type, void *data)
+{
+	if (type == STRING)
+		deallocString(data);
+	else
+		free(data);
+}
+
+/**
+ * Zvetseni rozptylovaci tabulky na dvojnasobek a prepocitani indexu
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode growHashTable()
+{
+	int newSize = constantPool.hashSize == 0 ? CONSTANT_POOL_HASH_INIT : constantPool.hashSize * 2;
+	int *newTable = malloc(newSize * sizeof(int));
+	if (newTable == NULL)
+		return ERR_MEMORY;
+
+	for (int i = 0; i < newSize; i++)
+		newTable[i] = -1;
+
+	// Prevlozeni existujicich konstant
+	for (int i = 0; i < constantPool.count; i++)
+	{
+		tVariable *value = constantPoolValue(i);
+		unsigned int slot = constantHash(value->semantic, value->value) & (newSize - 1);
+		while (newTable[slot] != -1)
+			slot = (slot + 1) & (newSize - 1);
+		newTable[slot] = i;
+	}
+
+	free(constantPool.hashTable);
+	constantPool.hashTable = newTable;
+	constantPool.hashSize = newSize;
+	return ERR_OK;
+}
+
+// Vlozeni literalu do tabulky konstant
+ecode constantPoolInsert(SemanticType type, void *data, tConstant **constant)
+{
+	ecode error;
+	unsigned int slot;
+	tVariable *newVar;
+	tConstant *newConstant;
+
+	// -------------- Udrzeni zaplneni rozptylovaci tabulky pod polovinou --------
+	if ((constantPool.count + 1) * 2 > constantPool.hashSize)
+	{
+		error = growHashTable();
+		if (error != ERR_OK)
+		{
+			freeConstantData(type, data);
+			return error;
+		}
+	}
+
+	// -------------- Hledani existujici konstanty ------------------------------
+	slot = constantHash(type, data) & (constantPool.hashSize - 1);
+	while (constantPool.hashTable[slot] != -1)
+	{
+		if (constantEquals(constantPoolValue(constantPool.hashTable[slot]), type, data))
+		{
+			freeConstantData(type, data);
+			*constant = constantPool.constants[constantPool.hashTable[slot]];
+			return ERR_OK;
+		}
+		slot = (slot + 1) & (constantPool.hashSize - 1);
+	}
+
+	// -------------- Zvetseni pole hodnot --------------------------------------
+	if (constantPool.count == constantPool.capacity)
+	{
+		error = growValues();
+		if (error != ERR_OK)
+		{
+			freeConstantData(type, data);
+			return error;
+		}
+	}
+
+	// -------------- Zvetseni pole operandu ------------------------------------
+	if (constantPool.count == constantPool.size)
+	{
+		int newSize = constantPool.size + CONSTANT_POOL_ALLOC_STEP;
+		tConstant **newConstants = realloc(constantPool.constants, newSize * sizeof(tConstant *));
+		if (newConstants == NULL)
+		{
+			freeConstantData(type, data);
+			return ERR_MEMORY;
+		}
+		constantPool.constants = newConstants;
+		constantPool.size = newSize;
+	}
+
+	// -------------- Vytvoreni nove konstanty (v arene prekladu) ---------------
+	newConstant = compileArenaAlloc(sizeof(tConstant));
+	if (newConstant == NULL)
+	{
+		freeConstantData(type, data);
+		return ERR_MEMORY;
+	}
+
+	error = createNewVariable(&newVar, type, data);
+	if (error != ERR_OK)
+	{
+		freeConstantData(type, data);
+		return error;
+	}
+
+	// Hodnota se presune do souvisleho pole, hlavicka promenne uz neni potreba
+	*constantPoolValue(constantPool.count) = *newVar;
+	free(newVar);
+
+	newConstant->offset = CONSTANT_OPERAND_OFFSET;
+	newConstant->index = constantPool.count;
+	constantPool.constants[constantPool.count] = newConstant;
+	constantPool.hashTable[slot] = constantPool.count;
+	constantPool.count++;
+
+	*constant = newConstant;
+	return ERR_OK;
+}
+
+// Uvolneni tabulky konstant
+void constantPoolFree()
+{
+	// Samotne konstanty jsou v arene prekladu, uvolni se s ni
+	for (int i = 0; i < constantPool.count; i++)
+		freeConstantData(constantPoolValue(i)->semantic, constantPoolValue(i)->value);
+
+#ifndef CONSTANT_POOL_USE_MALLOC
+	if (constantPool.mapped)
+		munmap(constantPool.values, constantPool.capacity * sizeof(tVariable));
+	else
+#endif
+		free(constantPool.values);
+	free(constantPool.constants);
+	free(constantPool.hashTable);
+
+	constantPool.values = NULL;
+	constantPool.capacity = 0;
+	constantPool.mapped = false;
+	constantPool.constants = NULL;
+	constantPool.hashTable = NULL;
+	constantPool.count = constantPool.size = constantPool.hashSize = 0;
+}
@@ -0,0 +1,81 @@
+// constant_pool.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Shared pool of immutable literals used as instruction operands             *
+ ******************************************************************************
+ */
+
+#ifndef CONSTANT_POOL_H
+#define CONSTANT_POOL_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include "errnum.h"
+#include "variable.h"
+
+// Hodnota offsetu, ktera oznacuje operand konstanty, na zasobniku nemuze byt
+#define CONSTANT_OPERAND_OFFSET INT_MIN
+
+// Velikost rezervovaneho virtualniho prostoru pro hodnoty konstant v bajtech,
+// stranky se alokuji az pri zapisu hodnot
+#ifndef CONSTANT_POOL_RESERVE
+#define CONSTANT_POOL_RESERVE (256L * 1024 * 1024)
+#endif
+
+// Operand instrukce odkazujici na konstantu. Prvni polozka je na stejnem
+// miste jako offset operandu (int *), podle ni se operandy rozlisuji
+typedef struct
+{
+	int offset;	// Vzdy CONSTANT_OPERAND_OFFSET
+	int index;	// Index hodnoty v tabulce konstant
+} tConstant;
+
+// Tabulka konstant programu. Pri linem prekladu funkci (PARSER_LAZY_FUNCTIONS)
+// roste i za behu interpretu, zatimco na zasobniku lezi ukazatele na jeji
+// hodnoty. Pole hodnot je proto rezervovano funkci mmap v rozsahu
+// CONSTANT_POOL_RESERVE a pri rozsirovani tabulky se nepresouva. Bez mmap
+// (CONSTANT_POOL_USE_MALLOC) se pole zvetsuje funkci realloc, coz je mozne
+// jen bez PARSER_LAZY_FUNCTIONS
+typedef struct
+{
+	tVariable *values;		// Souvisle pole hodnot konstant
+	int capacity;			// Pocet hodnot, ktere se do pole vejdou
+	bool mapped;			// Pole je rezervovano funkci mmap (jinak malloc)
+	tConstant **constants;	// Operandy jednotlivych konstant
+	int count;				// Pocet konstant
+	int size;				// Velikost alokovaneho pole operandu
+	int *hashTable;			// Rozptylovaci tabulka indexu pro hledani duplicit
+	int hashSize;			// Velikost rozptylovaci tabulky (mocnina dvou)
+} tConstantPool;
+
+extern tConstantPool constantPool;
+
+// Zjisti, zda operand instrukce odkazuje na konstantu
+#define isConstantOperand(operand) (*((int *) (operand)) == CONSTANT_OPERAND_OFFSET)
+// Hodnota konstanty, na kterou odkazuje operand
+#define constantOperandValue(operand) (&constantPool.values[((tConstant *) (operand))->index])
+// Hodnota konstanty podle indexu v tabulce
+#define constantPoolValue(index) (&constantPool.values[(index)])
+// Zjisti, zda promenna patri do tabulky konstant (nesmi se uvolnit ani menit)
+#define constantPoolContains(variable) ((tVariable *) (variable) >= constantPool.values && \
+                                        (tVariable *) (variable) < constantPool.values + constantPool.count)
+
+/**
+ * Vlozeni literalu do tabulky konstant. Pokud uz stejna konstanta existuje,
+ * vrati se jeji operand a predana data se uvolni
+ * @param  type     Datovy typ literalu (NIL, LOGICAL, NUMERIC, STRING, FUNCTION)
+ * @param  data     Hodnota literalu, tabulka prebira jeji vlastnictvi
+ * @param  constant Ukazatel pro ulozeni operandu konstanty
+ * @return          ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode constantPoolInsert(SemanticType type, void *data, tConstant **constant);
+
+/**
+ * Uvolneni tabulky konstant a vsech jejich hodnot
+ */
+void constantPoolFree();
+
+#endif // CONSTANT_POOL_H
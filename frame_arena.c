@@ -0,0 +1,179 @@
+// frame_arena.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Bump arena for values that live only within one function frame           *
+ ******************************************************************************
+ */
+#include "frame_arena.h"
+#include "errnum.h"
+#include "libstring.h"
+#include "variable.h"
+#include "variable_pool.h"
+#include <stdlib.h>
+
+// Zarovnani alokaci v arene
+#define FRAME_ARENA_ALIGN 8
+#define alignSize(size) (((size) + FRAME_ARENA_ALIGN - 1) & ~((size_t) FRAME_ARENA_ALIGN - 1))
+
+tFrameArena frameArena = { NULL, NULL, 0, NULL };
+
+// Inicializace areny
+ecode frameArenaInit(size_t size)
+{
+	frameArena.data = malloc(size);
+	if (frameArena.data == NULL)
+		return ERR_MEMORY;
+
+	frameArena.top = frameArena.data;
+	frameArena.size = size;
+	frameArena.freeList = NULL;
+	return ERR_OK;
+}
+
+// Alokace z vrcholu areny
+void *frameArenaAlloc(size_t size)
+{
+	void *memory;
+
+	size = alignSize(size);
+	if (frameArena.data == NULL || (size_t) (frameArena.data + frameArena.size - frameArena.top) < size)
+		return NULL;
+
+	memory = frameArena.top;
+	frameArena.top += size;
+	return memory;
+}
+
+// Otevreni ramce volane funkce
+ecode frameArenaPush(int basePointer, tFrameMark **mark)
+{
+	char *top = frameArena.top;
+	tFrameMark *newMark = frameArenaAlloc(sizeof(tFrameMark));
+
+	// Plna arena - zaznam z poolu, uvolni ho frameArenaReleaseVariable
+	if (newMark == NULL)
+	{
+		newMark = variablePoolAlloc(sizeof(tFrameMark));
+		if (newMark == NULL)
+			return ERR_MEMORY;
+	}
+
+	newMark->basePointer = basePointer;
+	newMark->top = top;
+	newMark->freeList = frameArena.freeList;
+	frameArena.freeList = NULL;
+
+	*mark = newMark;
+	return ERR_OK;
+}
+
+// Uvolneni hodnot ramce
+void frameArenaPop(tFrameMark mark)
+{
+	frameArena.top = mark.top;
+	frameArena.freeList = mark.freeList;
+}
+
+// Vytvoreni promenne s hlavickou v arene
+ecode frameArenaCreateVariable(tVariable **variable, SemanticType type, void *value)
+{
+	tVariable *newVar;
+
+	// -------------- Hlavicka ze seznamu volnych nebo z vrcholu areny ----------
+	if (frameArena.freeList != NULL)
+	{
+		newVar = frameArena.freeList;
+		frameArena.freeList = *((void **) newVar);
+	}
+	else
+	{
+		// Plna arena - hlavicka z poolu
+		newVar = frameArenaAlloc(sizeof(tVariable));
+		if (newVar == NULL)
+			newVar = variablePoolAlloc(sizeof(tVariable));
+		if (newVar == NULL)
+			return ERR_MEMORY;
+	}
+
+	newVar->semantic = type;
+	newVar->value = value;
+	*variable = newVar;
+	return ERR_OK;
+}
+
+/**
+ * Uvolneni hodnoty promenne, hodnota v arene se neuvolnuje, skalarni hodnoty
+ * vraci do poolu (mimo pool je uvolni free)
+ * @param var Promenna, jejiz hodnota se uvolni
+ */
+static void releaseValue(tVariable *var)
+{
+	if (frameArenaContains(var->value))
+		return;
+
+	switch (var->semantic)
+	{
+		case STRING:
+			deallocString(var->value);
+			break;
+		case LOGICAL:
+		case NUMERIC:
+		case RANGE:
+		case BASE_POINTER:
+			variablePoolRelease(var->value);
+			break;
+		default:	// Hodnotu nevlastni (UNDEFINED, NIL, FUNCTION, INSTRUCTION_POINTER)
+			break;
+	}
+}
+
+// Uvolneni promenne
+void frameArenaReleaseVariable(tVariable **variable)
+{
+	tVariable *var = *variable;
+
+	if (var == NULL)
+		return;
+
+	// -------------- Hlavicka z poolu ------------------------------------------
+	if (variablePoolContains(var))
+	{
+		releaseValue(var);
+		variablePoolRelease(var);
+		*variable = NULL;
+		return;
+	}
+
+	// -------------- Hlavicka mimo arenu (createNewVariable, copyVariable) ----
+	if (!frameArenaContains(var))
+	{
+		// Hodnotu z poolu nesmi uvolnit freeVariable
+		if (variablePoolContains(var->value))
+		{
+			variablePoolRelease(var->value);
+			var->value = NULL;
+		}
+		freeVariable(variable);
+		return;
+	}
+
+	// -------------- Uvolneni hodnoty ------------------------------------------
+	releaseValue(var);
+
+	// -------------- Hlavicka do seznamu volnych hlavicek ramce ----------------
+	*((void **) var) = frameArena.freeList;
+	frameArena.freeList = var;
+	*variable = NULL;
+}
+
+// Uvolneni areny
+void frameArenaFree()
+{
+	free(frameArena.data);
+	frameArena.data = frameArena.top = NULL;
+	frameArena.size = 0;
+	frameArena.freeList = NULL;
+}
@@ -0,0 +1,98 @@
+// frame_arena.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Bump arena for values that live only within one function frame           *
+ ******************************************************************************
+ */
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <stddef.h>
+#include "errnum.h"
+#include "variable.h"
+
+// Velikost areny, po jejim zaplneni se promenne alokuji na halde
+#ifndef FRAME_ARENA_SIZE
+#define FRAME_ARENA_SIZE (1024 * 1024)
+#endif
+
+// Arena ramcu funkci - souvisly blok pameti, uvolnuje se po ramcich
+typedef struct
+{
+	char *data;			// Zacatek bloku
+	char *top;			// Prvni volny bajt
+	size_t size;		// Velikost bloku
+	void *freeList;		// Uvolnene hlavicky promennych aktualniho ramce
+} tFrameArena;
+
+// Zaznam volani funkce ulozeny v arene, hodnota promenne BASE_POINTER
+// Puvodni base pointer musi byt prvni polozkou, INSTR_RET ho cte jako int
+typedef struct
+{
+	int basePointer;	// Base pointer volajici funkce
+	char *top;			// Vrchol areny pred volanim
+	void *freeList;		// Uvolnene hlavicky volajici funkce
+} tFrameMark;
+
+extern tFrameArena frameArena;
+
+// Zjisti, zda ukazatel lezi v arene (nesmi se uvolnit funkci free)
+#define frameArenaContains(pointer) ((char *) (pointer) >= frameArena.data && \
+                                     (char *) (pointer) < frameArena.data + frameArena.size)
+
+/**
+ * Inicializace areny
+ * @param  size Velikost areny v bajtech
+ * @return      ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+ecode frameArenaInit(size_t size);
+
+/**
+ * Alokace pameti z vrcholu areny
+ * @param  size Velikost v bajtech
+ * @return      Ukazatel na pamet nebo NULL, pokud je arena plna
+ */
+void *frameArenaAlloc(size_t size);
+
+/**
+ * Otevreni ramce volane funkce. Vytvori zaznam volani s aktualnim stavem
+ * areny, nove uvolnene hlavicky patri jen volane funkci
+ * @param  basePointer Base pointer volajici funkce
+ * @param  mark        Ukazatel pro ulozeni zaznamu volani
+ * @return             ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+ecode frameArenaPush(int basePointer, tFrameMark **mark);
+
+/**
+ * Uvolneni vsech hodnot ramce najednou navratem vrcholu areny do stavu
+ * pred volanim funkce
+ * @param mark Zaznam volani (kopie, puvodni zaznam lezi v uvolnovane pameti)
+ */
+void frameArenaPop(tFrameMark mark);
+
+/**
+ * Vytvoreni promenne s hlavickou v arene, pri zaplneni areny na halde
+ * @param  variable Ukazatel pro ulozeni promenne
+ * @param  type     Datovy typ promenne
+ * @param  value    Hodnota promenne
+ * @return          ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode frameArenaCreateVariable(tVariable **variable, SemanticType type, void *value);
+
+/**
+ * Uvolneni promenne. Hlavicka z areny se vrati do seznamu volnych hlavicek
+ * ramce a uvolni se jen jeji hodnota, ostatni promenne uvolni freeVariable
+ * @param variable Ukazatel na uvolnovanou promennou, nastavi se na NULL
+ */
+void frameArenaReleaseVariable(tVariable **variable);
+
+/**
+ * Uvolneni areny
+ */
+void frameArenaFree();
+
+#endif // FRAME_ARENA_H
@@ -8,12 +8,63 @@
  */
 
 #include "ilist.h"
+#include "compile_arena.h"
+#include "constant_pool.h"
 #include "errnum.h"
 #include "global.h"
 #include "variable.h"
 #include <stdio.h>
 #include <stdlib.h>
 
+#define OPERAND_LIST_ALLOC_STEP 4
+
+/**
+ * Uvolneni promenne s literalem instrukce INSTR_MOV
+ * @param variable Uvolnovana promenna
+ */
+static void releaseMovOperand(void *variable)
+{
+	freeVariable((tVariable **) &variable);
+}
+
+/**
+ * Prevod operandu offsetu (int *) nebo konstanty (tConstant *) na operand
+ * ulozeny primo v instrukci
+ * @param operand Prevadeny operand nebo NULL
+ * @param kind    Ukazatel pro ulozeni druhu operandu
+ * @param value   Ukazatel pro ulozeni hodnoty operandu
+ */
+static void decodeOperand(void *operand, unsigned char *kind, tOperand *value)
+{
+	if (operand == NULL)
+	{
+		*kind = OPERAND_NONE;
+		value->pointer = NULL;
+	}
+	else if (isConstantOperand(operand))
+	{
+		*kind = OPERAND_CONSTANT;
+		value->constant = ((tConstant *) operand)->index;
+	}
+	else
+	{
+		*kind = OPERAND_OFFSET;
+		value->offset = *((int *) operand);
+	}
+}
+
+/**
+ * Ulozeni operandu, ktery je ukazatelem (navesti, zaznam funkce, ...)
+ * @param operand Ukazatel nebo NULL
+ * @param kind    Ukazatel pro ulozeni druhu operandu
+ * @param value   Ukazatel pro ulozeni hodnoty operandu
+ */
+static void pointerOperand(void *operand, unsigned char *kind, tOperand *value)
+{
+	*kind = operand == NULL ? OPERAND_NONE : OPERAND_POINTER;
+	value->pointer = operand;
+}
+
 // Inicializace seznamu instrukci
 ecode tIListInit(tIList *list)
 {
@@ -27,26 +78,17 @@ ecode tIListInit(tIList *list)
 // Uvolneni seznamu instrukci
 ecode tIListFree(tIList *list)
 {
-	tIListItem *tmp;
 	if (list == NULL)
 		return ERR_LIST;
 
-	while (list->first != NULL)
-	{
-		tmp = list->first->nextItem;
-		// Uvolneni literalu alokovanych na halde
-		if (list->first->instruction->instruction == INSTR_PUSH)
-		{
-			freeVariable((tVariable **)&(list->first->instruction->op1));
-		}
-		else if (list->first->instruction->instruction == INSTR_MOV)
-		{
-			freeVariable((tVariable **) &(list->first->instruction->op2));
-		}
-		free(list->first->instruction);
-		free(list->first);
-		list->first = tmp;
-	}
+	// Konstanty instrukci jsou ve sdilene tabulce konstant
+	constantPoolFree();
+
+	// Polozky, instrukce a offsety jsou v arene prekladu, uvolni se najednou
+	// spolu s literaly a tabulkami posunu registrovanymi pri vkladani
+	compileArenaFree();
+
+	list->active = list->first = list->last = NULL;
 	return ERR_OK;
 }
 // Vlozeni posledni instrukce
@@ -55,10 +97,22 @@ ecode tIListInsertLast(tIList *list, tInstruction *instruction)
 	if (list == NULL)
 		return ERR_LIST;
 
-	tIListItem *tmp = malloc(sizeof(tIListItem));
+	tIListItem *tmp = compileArenaAlloc(sizeof(tIListItem));
 	if (tmp == NULL)
 		return ERR_MEMORY;
 
+	// -------------- Operandy mimo arenu se uvolni spolu s ni ------------------
+	if (instruction->instruction == INSTR_MOV && instruction->kind2 == OPERAND_POINTER)
+	{
+		if (compileArenaRegister(instruction->op2.pointer, releaseMovOperand) != ERR_OK)
+			return ERR_MEMORY;
+	}
+	else if (instruction->instruction == INSTR_FIND && instruction->kind3 == OPERAND_POINTER)
+	{
+		if (compileArenaRegister(instruction->op3.pointer, free) != ERR_OK)
+			return ERR_MEMORY;
+	}
+
 	tmp->lineNumber = _lineNumber;
 	tmp->nextItem = NULL;
 	tmp->instruction = instruction;
@@ -77,6 +131,25 @@ ecode tIListInsertLast(tIList *list, tInstruction *instruction)
 	return ERR_OK;
 }
 
+// Pripojeni jineho seznamu na konec seznamu
+ecode tIListAppendList(tIList *list, tIList *segment)
+{
+	if (list == NULL || segment == NULL)
+		return ERR_LIST;
+
+	if (segment->first == NULL)
+		return ERR_OK;
+
+	if (list->last == NULL)
+		list->first = segment->first;
+	else
+		list->last->nextItem = segment->first;
+
+	list->last = segment->last;
+	segment->active = segment->first = segment->last = NULL;
+	return ERR_OK;
+}
+
 // Nastaveni aktivni instrukce na nasledujici
 ecode tIListNext(tIList *list)
 {
@@ -120,14 +193,86 @@ tInstruction *tIListGetActiveInstruction(tIList *list)
 
 tInstruction *generateInstruction(InstructionType type, void *op1, void *op2, void *op3)
 {
-	tInstruction *newInstruction = malloc(sizeof(tInstruction));
+	tInstruction *newInstruction = compileArenaAlloc(sizeof(tInstruction));
 
 	if (newInstruction == NULL)
 		return NULL;
 	// Nastaveni operandu instrukce a typu instrukce
 	newInstruction->instruction = type;
-	newInstruction->op1 = op1;
-	newInstruction->op2 = op2;
-	newInstruction->op3 = op3;
+	decodeOperand(op1, &newInstruction->kind1, &newInstruction->op1);
+	decodeOperand(op2, &newInstruction->kind2, &newInstruction->op2);
+	decodeOperand(op3, &newInstruction->kind3, &newInstruction->op3);
+
+	// -------------- Operandy, ktere nejsou offsetem ani konstantou ------------
+	switch (type)
+	{
+		case INSTR_GOTO:
+		case INSTR_IFGOTO:
+		case INSTR_CALL:
+			pointerOperand(op1, &newInstruction->kind1, &newInstruction->op1);
+			break;
+		case INSTR_RET:
+			if (op1 != NULL)
+			{
+				newInstruction->kind1 = OPERAND_IMMEDIATE;
+				newInstruction->op1.immediate = *((int *) op1);
+			}
+			break;
+		case INSTR_MOV:
+		case INSTR_PRINT:
+			pointerOperand(op2, &newInstruction->kind2, &newInstruction->op2);
+			break;
+		case INSTR_FIND:
+			pointerOperand(op2, &newInstruction->kind2, &newInstruction->op2);
+			pointerOperand(op3, &newInstruction->kind3, &newInstruction->op3);
+			break;
+		default:
+			break;
+	}
 	return newInstruction;
 }
+
+// Vytvoreni prazdneho seznamu operandu
+ecode tOperandListInit(tOperandList **list)
+{
+	*list = malloc(sizeof(tOperandList) + OPERAND_LIST_ALLOC_STEP * sizeof(void *));
+	if (*list == NULL)
+		return ERR_MEMORY;
+
+	(*list)->count = 0;
+	(*list)->size = OPERAND_LIST_ALLOC_STEP;
+	return ERR_OK;
+}
+
+// Pridani operandu na konec seznamu
+ecode tOperandListAppend(tOperandList **list, void *operand)
+{
+	if ((*list)->count == (*list)->size)
+	{
+		int newSize = (*list)->size + OPERAND_LIST_ALLOC_STEP;
+		tOperandList *newList = realloc(*list, sizeof(tOperandList) + newSize * sizeof(void *));
+		if (newList == NULL)
+			return ERR_MEMORY;
+
+		newList->size = newSize;
+		*list = newList;
+	}
+
+	(*list)->operands[(*list)->count++] = operand;
+	return ERR_OK;
+}
+
+// Prevod seznamu operandu na pole operandu v arene prekladu
+tOperandArray *tOperandListCompact(tOperandList *list)
+{
+	tOperandArray *compact = compileArenaAlloc(sizeof(tOperandArray) + list->count * sizeof(tListOperand));
+	if (compact != NULL)
+	{
+		compact->count = list->count;
+		for (int i = 0; i < list->count; i++)
+			decodeOperand(list->operands[i], &compact->operands[i].kind, &compact->operands[i].operand);
+	}
+
+	free(list);
+	return compact;
+}
@@ -20,9 +20,14 @@
 typedef enum {
     // Pokud neni dano jinak, adresuji instrukce pomoci offset na stacku
     // kde offset je int *offset
+    // Cteny operand muze byt misto offsetu konstanta (tConstant *) z tabulky
+    // konstant, rozlisi se podle hodnoty CONSTANT_OPERAND_OFFSET
+    // Popis plati pro parametry generateInstruction, v instrukci se operandy
+    // ulozi primo (viz tOperand a OperandKind)
 
     // Ridici instrukce
-    // LABEL je tIListItem **
+    // LABEL je tIListItem * (instrukce navesti), doplni se po prekladu funkce
+    // z tabulky navesti (label_stack.h)
     // Instrukce skoku
     INSTR_GOTO,             // op1 = LABEL, op2 = op3 = NULL
     // Instrukce podmineneho skoku
@@ -31,7 +36,7 @@ typedef enum {
     // Instrukce volani podprogramu
     INSTR_CALL,             // op1 = functionRecord *, op2 = op3 = NULL
     // Instrukce navratu z podprogramu, uvolni zadany pocet parametru,
-    INSTR_RET,              // op1 = *int  op2 = op3 = NULL
+    INSTR_RET,              // op1 = *int (pocet parametru)  op2 = op3 = NULL
     // Instrukce konce programu
     INSTR_HALT,             // op1 = op2 = op3 = NULL
     // Instrukce navesti
@@ -74,22 +79,27 @@ typedef enum {
 
     // Instrukce pro praci nad zasobnikem
     // Na zasobnik se ukladaji void*
-    INSTR_PUSH,             // Instrukce pro ulozeni hodnoty na zasobnik op1 = void *
+    INSTR_PUSH,             // Instrukce pro ulozeni konstanty na zasobnik bez kopirovani op1 = tConstant *
     INSTR_PUSH_STACK,       // op1 = offset
     INSTR_POP,              // Instrukce pro odebrani hodnoty ze zasobniku
 
 
-    // Instrukce pro vnitrni funkce
-    INSTR_INPUT,            // Zpracovani vstupu
-    INSTR_NUMERIC,          // Konverze na cislo
+    // Instrukce pro vnitrni funkce, volaji se primo bez ramce funkce
+    // op1 = offset vysledku, parametry jsou operandy (offset nebo konstanta)
+    INSTR_INPUT,            // Zpracovani vstupu                    op2 = op3 = NULL
+    INSTR_NUMERIC,          // Konverze na cislo                    op2 = parametr, op3 = NULL
     INSTR_PRINT,            // Vypisuje hodnoty termu na standardni vystup
-    INSTR_TYPEOF,           // Vrati ciselny identifikator datoveho typu
-    INSTR_LEN,              // Vrati delku retezce
+                            // op2 = tOperandArray * parametru, op3 = NULL
+    INSTR_TYPEOF,           // Vrati ciselny identifikator datoveho typu op2 = parametr, op3 = NULL
+    INSTR_LEN,              // Vrati delku retezce                  op2 = parametr, op3 = NULL
     INSTR_FIND,             // Hleda vyskyt podretezce v retezci
-    INSTR_SORT,             // Seradi znaky v danem retezci
+                            // op2 = tOperandArray * se dvema parametry,
+                            // op3 = tSearchTable * pro konstantni podretezec nebo NULL
+    INSTR_SORT,             // Seradi znaky v danem retezci         op2 = parametr, op3 = NULL
 
 
     // Instrukce pro vlozeni polozky na zasobnik
+    // Pouziva se jen pro hodnoty, ktere nejsou v tabulce konstant (tRange)
     INSTR_MOV,              // target = offset, op1 = void *, op2 = NULL
     // Instrukce pro vytvoreni kopie polozky na zasobniku
     // zaroven si alokuje prostor na zasobniku
@@ -97,15 +107,59 @@ typedef enum {
     INSTR_REMOVE_STACK          // target = offset, op1 = op2 = NULL
 } InstructionType;
 
+// Druh operandu ulozeneho v instrukci
+typedef enum {
+    OPERAND_NONE,           // Operand neni pouzit
+    OPERAND_OFFSET,         // Offset promenne na zasobniku
+    OPERAND_CONSTANT,       // Index hodnoty v tabulce konstant
+    OPERAND_IMMEDIATE,      // Cele cislo (pocet parametru INSTR_RET)
+    OPERAND_POINTER         // Navesti, zaznam funkce, literal, seznam operandu
+                            // nebo tabulka posunu
+} OperandKind;
+
+// Operand instrukce, vyznam urcuje jeho druh
+typedef union {
+    int offset;             // OPERAND_OFFSET
+    int constant;           // OPERAND_CONSTANT
+    int immediate;          // OPERAND_IMMEDIATE
+    void *pointer;          // OPERAND_POINTER
+} tOperand;
+
 // Struktura instrukce
 typedef struct t_instruction
 {
     InstructionType instruction;    // Typ instrukce
-    void *op1;      // 1. operand
-    void *op2;      // 2. operand
-    void *op3;
+    unsigned char kind1;            // Druh 1. operandu (OperandKind)
+    unsigned char kind2;            // Druh 2. operandu
+    unsigned char kind3;            // Druh 3. operandu
+    tOperand op1;   // 1. operand
+    tOperand op2;   // 2. operand
+    tOperand op3;
 } tInstruction;
 
+// Seznam operandu instrukce s promennym poctem parametru (print, find)
+// pri prekladu
+typedef struct
+{
+    int count;          // Pocet operandu
+    int size;           // Velikost alokovaneho pole operandu
+    void *operands[];   // Operandy (int *offset nebo tConstant *)
+} tOperandList;
+
+// Operand s druhem v seznamu operandu instrukce
+typedef struct
+{
+    unsigned char kind;     // Druh operandu (OperandKind)
+    tOperand operand;
+} tListOperand;
+
+// Hotovy seznam operandu instrukce print nebo find v arene prekladu
+typedef struct
+{
+    int count;                  // Pocet operandu
+    tListOperand operands[];    // Operandy (offset nebo konstanta)
+} tOperandArray;
+
 // Polozka seznamu instrukci
 typedef struct t_listItem
 {
@@ -131,6 +185,7 @@ ecode tIListInit(tIList *list);
 
 /**
  * Uvolneni seznamu instrukci a literalu, ktere instrukce obsahuji
+ * Instrukce jsou v arene prekladu, uvolni se spolu s ni
  * @param  list Ukazatel na seznam
  * @return      ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
@@ -144,6 +199,15 @@ ecode tIListFree(tIList *list);
  */
 ecode tIListInsertLast(tIList *list, tInstruction *instruction);
 
+/**
+ * Pripojeni vsech instrukci jineho seznamu na konec seznamu, polozky se
+ * nekopiruji a pripojeny seznam zustane prazdny
+ * @param  list    Ukazatel na seznam
+ * @param  segment Ukazatel na pripojovany seznam
+ * @return         ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode tIListAppendList(tIList *list, tIList *segment);
+
 /**
  * Zmena aktivni instrukce na nasleduji
  * @param  list Ukazatel na instrukci
@@ -174,9 +238,34 @@ tIListItem *tIListGetLast(tIList *list);
 tInstruction *tIListGetActiveInstruction(tIList *list);
 
 
-// Vygeneruje instrukci podle zadanych parametru
+// Vygeneruje instrukci podle zadanych parametru, instrukce je v arene prekladu
+// a neuvolnuje se funkci free. Operandy (int *, tConstant *) se prevedou na
+// primo ulozene hodnoty, offset uz se po vygenerovani instrukce nesmi menit
 tInstruction *generateInstruction(InstructionType type, void *op1, void *op2, void *op3);
 
+/**
+ * Vytvoreni prazdneho seznamu operandu
+ * @param  list Ukazatel pro ulozeni seznamu
+ * @return      ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode tOperandListInit(tOperandList **list);
+
+/**
+ * Pridani operandu na konec seznamu, seznam se pripadne realokuje
+ * @param  list    Ukazatel na seznam
+ * @param  operand Pridavany operand
+ * @return         ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode tOperandListAppend(tOperandList **list, void *operand);
+
+/**
+ * Prevod hotoveho seznamu operandu na pole operandu v arene prekladu,
+ * puvodni seznam se uvolni
+ * @param  list Seznam operandu
+ * @return      Pole operandu v arene nebo NULL pri nedostatku pameti
+ */
+tOperandArray *tOperandListCompact(tOperandList *list);
+
 
 
 
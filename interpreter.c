@@ -10,15 +10,27 @@
 
 #include <math.h>
 #include "interpreter.h"
+#include "constant_pool.h"
 #include "errnum.h"
+#include "frame_arena.h"
 #include "global.h"
 #include "libstring.h"
+#include "number_conversion.h"
+#include "output_buffer.h"
+#include "parser_dropdown.h"
 #include "runtime_stack.h"
+#include "string_ops.h"
 #include "variable.h"
+#include "variable_pool.h"
 
 ecode interpreterInit(tIList *instrList);
 ecode insertNewVariable(int offset);
+ecode readOperand(unsigned char kind, tOperand operand, tVariable **variable);
+ecode readRangeOperand(void *operand, tVariable **variable);
+void releaseVariable(tVariable **variable);
+ecode storeResult(int offset, SemanticType type, void *value);
 String *convertVariableToString(tVariable *srcVar);
+int formatScalarVariable(tVariable *srcVar, char *buffer, char **text);
 String *stringPower(String *base, double power);
 
 // Funkce pro jednotlive instrukce
@@ -58,19 +70,30 @@ tRuntimeStack *runtimeStack;
 ecode interpreter(tIList *instrList)
 {
 	ecode error;
-	runtimeStack = tRuntimeStackInit();
+	tInstruction *currentInstruction = NULL;
 
-	tInstruction *currentInstruction;
+	// ------------------ Inicializace vystupniho bufferu ----------------------------
+	error = outputBufferInit(OUTPUT_BUFFER_SIZE);
 
-	// ------------------ Nastavi prvni instrukci na aktivni -------------------------
-	error = interpreterInit(instrList);
-	if (error != ERR_OK) return error;
+	// ------------------ Inicializace areny ramcu funkci a poolu promennych ---------
+	if (error == ERR_OK)
+		error = frameArenaInit(FRAME_ARENA_SIZE);
+	if (error == ERR_OK)
+		error = variablePoolInit(VARIABLE_POOL_SIZE);
 
-	currentInstruction = tIListGetActiveInstruction(instrList);
-	if (currentInstruction == NULL) return ERR_LIST;
+	// ------------------ Behovy zasobnik az po ostatnich prostredcich ---------------
+	runtimeStack = NULL;
+	if (error == ERR_OK && (runtimeStack = tRuntimeStackInit()) == NULL)
+		error = ERR_MEMORY;
 
 	// ------------------ Nastavi prvni instrukci na aktivni -------------------------
-	while (currentInstruction->instruction != INSTR_HALT)
+	if (error == ERR_OK)
+		error = interpreterInit(instrList);
+	if (error == ERR_OK && (currentInstruction = tIListGetActiveInstruction(instrList)) == NULL)
+		error = ERR_LIST;
+
+	// ------------------ Interpretace instrukci do instrukce HALT nebo chyby --------
+	while (error == ERR_OK && currentInstruction->instruction != INSTR_HALT)
 	{
 		switch (currentInstruction->instruction)
 		{
@@ -156,31 +179,30 @@ ecode interpreter(tIList *instrList)
 				error = instructionRemoveStack(currentInstruction);
 			break;
 		}
-		if(error != ERR_OK)
-		{
-			tRuntimeStackDispose(runtimeStack);
-			return error;
-		}
 
-		if (currentInstruction->instruction != INSTR_RET && instrList->active->instruction->instruction != INSTR_HALT)
-		{
+		if (error == ERR_OK && currentInstruction->instruction != INSTR_RET &&
+		    instrList->active->instruction->instruction != INSTR_HALT)
 			error = tIListNext(instrList);
-			if(error != ERR_OK)
-				return error;
-		}
 
-		currentInstruction = tIListGetActiveInstruction(instrList);
-		if (currentInstruction == NULL)
-		{
-			tRuntimeStackDispose(runtimeStack);
-			return ERR_LIST;
-		}
+		if (error == ERR_OK && (currentInstruction = tIListGetActiveInstruction(instrList)) == NULL)
+			error = ERR_LIST;
 	}
 
-	tRuntimeStackDispose(runtimeStack);
+	// ------------------ Instrukce HALT - vypis zbytku vystupu ----------------------
+	if (error == ERR_OK)
+		error = outputBufferFlush();
+
+	// ------------------ Uvolneni prostredku, spolecne pro vsechny konce ------------
+	// Pri chybe se vypise vse, co program vytiskl pred ni. Zasobnik se uvolnuje
+	// pred arenou ramcu, jeho promenne jsou v ni
+	outputBufferFree();
+	if (runtimeStack != NULL)
+		tRuntimeStackDispose(runtimeStack);
 	runtimeStack = NULL;
+	frameArenaFree();
+	variablePoolDispose();
 
-	return ERR_OK;
+	return error;
 }
 
 /**
@@ -233,8 +255,8 @@ ecode insertNewVariable(int offset)
 	ecode error;
 	tVariable *newVar;
 
-	// -------------- Vytvoreni nove nedefinovane promenne -----------------------
-	error = createNewVariable(&newVar, UNDEFINED, NULL);
+	// -------------- Vytvoreni nove nedefinovane promenne v arene ramce ---------
+	error = frameArenaCreateVariable(&newVar, UNDEFINED, NULL);
 	if (error != ERR_OK)
 		return error;
 
@@ -242,7 +264,103 @@ ecode insertNewVariable(int offset)
 	error = tRuntimeStackInsert(runtimeStack, offset, newVar);
 	if (error != ERR_OK)
 	{
-		freeVariable(&newVar);
+		frameArenaReleaseVariable(&newVar);
+		return error;
+	}
+	return ERR_OK;
+}
+
+/**
+ * Nacteni operandu instrukce. Operand je bud offset promenne na zasobniku,
+ * nebo index do tabulky konstant, jehoz hodnota se nekopiruje
+ * @param kind       Druh operandu (OPERAND_OFFSET nebo OPERAND_CONSTANT)
+ * @param operand    Operand instrukce
+ * @param **variable Ukazatel pro ulozeni nactene promenne
+ * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
+ */
+ecode readOperand(unsigned char kind, tOperand operand, tVariable **variable)
+{
+	if (kind == OPERAND_CONSTANT)
+	{
+		*variable = constantPoolValue(operand.constant);
+		return ERR_OK;
+	}
+	else if (kind != OPERAND_OFFSET)
+		return ERR_INSTR_WRONG_OPERANDS;
+
+	return tRuntimeStackRead(runtimeStack, operand.offset, (void **) variable);
+}
+
+/**
+ * Nacteni meze rozsahu podretezce. Rozsah (tRange) neni v instrukci,
+ * meze zustavaji jako int * offset nebo tConstant *
+ * @param *operand   Mez rozsahu (int * nebo tConstant *)
+ * @param **variable Ukazatel pro ulozeni nactene promenne
+ * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
+ */
+ecode readRangeOperand(void *operand, tVariable **variable)
+{
+	if (isConstantOperand(operand))
+	{
+		*variable = constantOperandValue(operand);
+		return ERR_OK;
+	}
+
+	return tRuntimeStackRead(runtimeStack, *((int *) operand), (void **) variable);
+}
+
+/**
+ * Uvolneni promenne ze zasobniku, konstanty z tabulky konstant patri
+ * programu a neuvolnuji se
+ * @param **variable Ukazatel na uvolnovanou promennou
+ */
+void releaseVariable(tVariable **variable)
+{
+	if (constantPoolContains(*variable))
+		*variable = NULL;
+	else
+		frameArenaReleaseVariable(variable);
+}
+
+/**
+ * Ulozeni vysledku vestavene funkce do nove promenne na offsetu operandu,
+ * puvodni promenna na offsetu se uvolni. Pri chybe se uvolni i hodnota
+ * @param offset   Offset promenne vysledku
+ * @param type     Datovy typ vysledku
+ * @param *value   Hodnota vysledku (promenna prebira jeji vlastnictvi)
+ * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
+ */
+ecode storeResult(int offset, SemanticType type, void *value)
+{
+	ecode error;
+	tVariable *result;
+
+	// -------------- Uvolneni puvodni promenne vysledku -------------------------
+	error = tRuntimeStackRead(runtimeStack, offset, (void **) &result);
+	if (error == ERR_OK && result != NULL)
+	{
+		releaseVariable(&result);
+		error = tRuntimeStackInsert(runtimeStack, offset, NULL);
+	}
+
+	// -------------- Vytvoreni promenne s vysledkem -----------------------------
+	if (error == ERR_OK)
+		error = frameArenaCreateVariable(&result, type, value);
+
+	if (error != ERR_OK)
+	{
+		if (type == STRING)
+			deallocString(value);
+		else
+			variablePoolRelease(value);
+		return error;
+	}
+
+	// -------------- Vlozeni promenne na zasobnik -------------------------------
+	error = tRuntimeStackInsert(runtimeStack, offset, result);
+	if (error != ERR_OK)
+	{
+		frameArenaReleaseVariable(&result);
 		return error;
 	}
 	return ERR_OK;
@@ -255,28 +373,51 @@ ecode insertNewVariable(int offset)
  */
 String *convertVariableToString(tVariable *srcVar)
 {
-	String *result;
+	char numberBuffer[NUMBER_FORMAT_MAX_LENGTH];
+	char *text;
+
 	if (srcVar->semantic == STRING)
+		return stringCopy(srcVar->value);
+
+	if (formatScalarVariable(srcVar, numberBuffer, &text) < 0)
+		return NULL;
+
+	return charToString(text);
+}
+
+/**
+ * Funkce pro ziskani textove podoby cisla, logicke hodnoty nebo nil bez
+ * alokace pameti. Cislo se zapise do predaneho bufferu, ostatni hodnoty
+ * ukazuji na konstantni retezce
+ * @param *srcVar Ukazatel na prevadenou promennou
+ * @param *buffer Buffer o velikosti alespon NUMBER_FORMAT_MAX_LENGTH
+ * @param **text  Ukazatel pro ulozeni ukazatele na text ukonceny nulou
+ * @return Delka textu, -1 pokud promenna nema textovou podobu
+ */
+int formatScalarVariable(tVariable *srcVar, char *buffer, char **text)
+{
+	if (srcVar->semantic == NUMERIC)
 	{
-		result = stringCopy(srcVar->value);
-	}
-	else if (srcVar->semantic == NUMERIC)
-	{
-		result = doubleToString( *((double *) srcVar->value) );
+		*text = buffer;
+		return numberFormat( *((double *) srcVar->value), buffer);
 	}
 	else if (srcVar->semantic == LOGICAL)
 	{
 		if (*((bool *)srcVar->value) == true)
-			result = charToString("true");
-		else
-			result = charToString("false");
+		{
+			*text = "true";
+			return 4;
+		}
+		*text = "false";
+		return 5;
 	}
 	else if (srcVar->semantic == NIL)
-		result = charToString("Nil");
-	else
-		result = NULL;
+	{
+		*text = "Nil";
+		return 3;
+	}
 
-	return result;
+	return -1;
 }
 
 /**
@@ -315,13 +456,13 @@ String *stringPower(String *base, double power)
 ecode instructionGoto(tIList *instrList, tInstruction *instruction)
 {
 	ecode error;
-	tIListItem **label;
+	tIListItem *label;
 
-	if (instruction->op1 == NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 != OPERAND_POINTER || instruction->kind2 != OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
-	label = (tIListItem **) instruction->op1;
-	error = tIListGoto(instrList, *label);
+	label = instruction->op1.pointer;
+	error = tIListGoto(instrList, label);
 	if (error != ERR_OK)
 		return error;
 
@@ -339,15 +480,15 @@ ecode instructionIfGoto(tIList *instrList, tInstruction *instruction)
 {
 	ecode error;
 	tVariable *condition;
-	tIListItem **jumpLabel;
-	jumpLabel = (tIListItem **) instruction->op1;
+	tIListItem *jumpLabel;
+	jumpLabel = instruction->op1.pointer;
 	bool doJump = false;
 
-	if (instruction->op1 == NULL || instruction->op2 == NULL || instruction->op3 != NULL)
+	if (instruction->kind1 != OPERAND_POINTER || instruction->kind2 == OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni promenne podminky ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op2), (void **) &condition);
+	error = readOperand(instruction->kind2, instruction->op2, &condition);
 	if (error != ERR_OK)
 		return error;
 
@@ -378,7 +519,7 @@ ecode instructionIfGoto(tIList *instrList, tInstruction *instruction)
 
 	if ( doJump )
 	{
-		error = tIListGoto(instrList, *jumpLabel);
+		error = tIListGoto(instrList, jumpLabel);
 		if (error != ERR_OK)
 			return error;
 	}
@@ -389,6 +530,8 @@ ecode instructionIfGoto(tIList *instrList, tInstruction *instruction)
 /**
  * Provedeni instrukce call, vlozeni IP a pote BP na runtimeStack (BP == SP),
  * posunuti SP pro lokani promenne a skok na prvni instrukci funkce v op1
+ * Zaznam volani (IP, BP) a hlavicky lokalnich promennych jsou v arene ramce,
+ * kterou INSTR_RET uvolni najednou
  * @param *instrList    Ukazatel na seznam instrukci
  * @param *instruction  Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
@@ -396,18 +539,33 @@ ecode instructionIfGoto(tIList *instrList, tInstruction *instruction)
 ecode instructionCall(tIList *instrList, tInstruction *instruction)
 {
 	ecode error;
-	int *basePointer;
+	tFrameMark *frameMark;
 	tVariable *pVariable = NULL;
 	tFunctionData *functionRecord = NULL;
 
-	if (instruction->op1 == NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 != OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni zaznamu volane funkce ---------------------------
-	functionRecord = ((tFunctionData *) instruction->op1);
+	functionRecord = instruction->op1.pointer;
+
+#ifdef PARSER_LAZY_FUNCTIONS
+	// -------------- Funkce se prelozi pri prvnim volani ---------------------
+	if (functionRecord->firstInstruction == NULL)
+	{
+		error = parseFunction(functionRecord);
+		if (error != ERR_OK)
+			return error;
+	}
+#endif
+
+	// -------------- Otevreni ramce v arene s puvodnim base pointerem --------
+	error = frameArenaPush(*runtimeStack->bp, &frameMark);
+	if (error != ERR_OK)
+		return error;
 
 	// -------------- Vytvoreni promenne instruction pointeru ------------------
-	error = createNewVariable(&pVariable, INSTRUCTION_POINTER, instrList->active->nextItem);
+	error = frameArenaCreateVariable(&pVariable, INSTRUCTION_POINTER, instrList->active->nextItem);
 	if (error != ERR_OK)
 		return error;
 
@@ -416,11 +574,8 @@ ecode instructionCall(tIList *instrList, tInstruction *instruction)
 	if (error != ERR_OK)
 		return error;
 
-	basePointer = (int*) malloc(sizeof(int));
-	*basePointer = *runtimeStack->bp;
-
 	// -------------- Vytvoreni promenne base ponteru -------------------------
-	error = createNewVariable(&pVariable, BASE_POINTER, basePointer);
+	error = frameArenaCreateVariable(&pVariable, BASE_POINTER, frameMark);
 	if (error != ERR_OK)
 		return error;
 
@@ -459,12 +614,13 @@ ecode instructionRet(tIList *instrList, tInstruction *instruction)
 	int paramsCount;
 	tVariable *pVariable;
 	tVariable *retVal;
+	tFrameMark frameMark;
 
-	if (instruction->op1 == NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 != OPERAND_IMMEDIATE || instruction->kind2 != OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni poctu mazanych parametru ------------------------
-	paramsCount = *((int *) instruction->op1) + 1;
+	paramsCount = instruction->op1.immediate + 1;
 
 	// -------------- Odstranovani dat z vrcholu  -----------------------------
 	while (runtimeStack->sp != *(runtimeStack->bp))
@@ -479,8 +635,11 @@ ecode instructionRet(tIList *instrList, tInstruction *instruction)
 	if (error != ERR_OK)
 		return error;
 
+	// Kopie zaznamu volani, puvodni lezi v uvolnovane casti areny
+	frameMark = *((tFrameMark *) pVariable->value);
+
 	// Nastaveni puvodni hodnoty base pointeru
-	*(runtimeStack->bp) = *((int *)pVariable->value);
+	*(runtimeStack->bp) = frameMark.basePointer;
 
 	// -------------- Odstraneni base pointeru z vrcholu ----------------------
 	error = tRuntimeStackPop(runtimeStack);
@@ -523,6 +682,10 @@ ecode instructionRet(tIList *instrList, tInstruction *instruction)
 	if (error)
 		return error;
 
+	// -------------- Uvolneni vsech hodnot ramce v arene ---------------------
+	// -------------- (navratova hodnota je kopie mimo arenu) -----------------
+	frameArenaPop(frameMark);
+
 	return ERR_OK;
 }
 
@@ -537,34 +700,38 @@ ecode instructionAdd(tInstruction *instruction)
 {
 	ecode error;
 	tVariable *result, *op1, *op2;
-	String *convertedVar;
+	String convertedVar = { 0 };	// Docasny retezec nad bufferem na zasobniku
+	char numberBuffer[NUMBER_FORMAT_MAX_LENGTH];
+	char *convertedText;
+	int convertedLength;
 
-	if (instruction->op1 == NULL || instruction->op2 == NULL || instruction->op3 == NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 == OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni promenne vysledku ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni prvniho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op2), (void **) &op1);
+	error = readOperand(instruction->kind2, instruction->op2, &op1);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni druheho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op3), (void **) &op2);
+	error = readOperand(instruction->kind3, instruction->op3, &op2);
 	if (error != ERR_OK)
 		return error;
 
-	if (result == NULL)	// Promenna pro vysledek jeste nebyla definovana
+	// Promenna pro vysledek jeste nebyla definovana nebo obsahuje sdilenou konstantu
+	if (result == NULL || constantPoolContains(result))
 	{
 		// -------------- Vytvoreni nove nedefinovane promenne -----------------------
-		error = insertNewVariable(*((int *) instruction->op1));
+		error = insertNewVariable(instruction->op1.offset);
 		if (error != ERR_OK)
 			return error;
 		// -------------- Nacteni promenne vysledku ----------------------------------
-		error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+		error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 		if (error != ERR_OK)
 			return error;
 	}
@@ -590,18 +757,19 @@ ecode instructionAdd(tInstruction *instruction)
 		if (error != ERR_OK)
 			return error;
 
-		// Pokud neni druhy operand retezec, tak ho z nej vytvorime
+		// Pokud neni druhy operand retezec, pouzije se jeho textova podoba
 		if (op2->semantic != STRING)
 		{
-			// -------------- Konverze druheho operandu na retezec -------------------
-			convertedVar = convertVariableToString(op2);
-			if (convertedVar == NULL)
+			// -------------- Textova podoba druheho operandu bez alokace ------------
+			convertedLength = formatScalarVariable(op2, numberBuffer, &convertedText);
+			if (convertedLength < 0)
 				return ERR_MEMORY;
 
-			// -------------- Konkatenace dvou retezcu -------------------------------
-			result->value = stringConcatenateNew(op1->value, convertedVar);
+			convertedVar.data = convertedText;
+			convertedVar.length = convertedLength;
 
-			deallocString(convertedVar);
+			// -------------- Konkatenace do jedineho noveho retezce -----------------
+			result->value = stringConcatenateNew(op1->value, &convertedVar);
 		}
 		else
 			result->value = stringConcatenateNew(op1->value, op2->value);
@@ -630,32 +798,33 @@ ecode instructionSubtract(tInstruction *instruction)
 	ecode error;
 	tVariable *result, *op1, *op2;
 
-	if (instruction->op1 == NULL || instruction->op2 == NULL || instruction->op3 == NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 == OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni promenne vysledku ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni prvniho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op2), (void **) &op1);
+	error = readOperand(instruction->kind2, instruction->op2, &op1);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni druheho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op3), (void **) &op2);
+	error = readOperand(instruction->kind3, instruction->op3, &op2);
 	if (error != ERR_OK)
 		return error;
 
-	if (result == NULL)	// Promenna pro vysledek jeste nebyla definovana
+	// Promenna pro vysledek jeste nebyla definovana nebo obsahuje sdilenou konstantu
+	if (result == NULL || constantPoolContains(result))
 	{
 		// -------------- Vytvoreni nove nedefinovane promenne -----------------------
-		error = insertNewVariable(*((int *) instruction->op1));
+		error = insertNewVariable(instruction->op1.offset);
 		if (error != ERR_OK)
 			return error;
 		// -------------- Nacteni promenne vysledku ----------------------------------
-		error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+		error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 		if (error != ERR_OK)
 			return error;
 	}
@@ -695,33 +864,34 @@ ecode instructionMultiply(tInstruction *instruction)
 	ecode error;
 	tVariable *result, *op1, *op2;
 
-	if (instruction->op1 == NULL || instruction->op2 == NULL || instruction->op3 == NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 == OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni promenne vysledku ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni prvniho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op2), (void **) &op1);
+	error = readOperand(instruction->kind2, instruction->op2, &op1);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni druheho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op3), (void **) &op2);
+	error = readOperand(instruction->kind3, instruction->op3, &op2);
 	if (error != ERR_OK)
 		return error;
 
 
-	if (result == NULL)	// Promenna pro vysledek jeste nebyla definovana
+	// Promenna pro vysledek jeste nebyla definovana nebo obsahuje sdilenou konstantu
+	if (result == NULL || constantPoolContains(result))
 	{
 		// -------------- Vytvoreni nove nedefinovane promenne -----------------------
-		error = insertNewVariable(*((int *) instruction->op1));
+		error = insertNewVariable(instruction->op1.offset);
 		if (error != ERR_OK)
 			return error;
 		// -------------- Nacteni promenne vysledku ----------------------------------
-		error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+		error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 		if (error != ERR_OK)
 			return error;
 	}
@@ -773,33 +943,34 @@ ecode instructionDivide(tInstruction *instruction)
 	ecode error;
 	tVariable *result, *op1, *op2;
 
-	if (instruction->op1 == NULL || instruction->op2 == NULL || instruction->op3 == NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 == OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni promenne vysledku ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni prvniho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op2), (void **) &op1);
+	error = readOperand(instruction->kind2, instruction->op2, &op1);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni druheho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op3), (void **) &op2);
+	error = readOperand(instruction->kind3, instruction->op3, &op2);
 	if (error != ERR_OK)
 		return error;
 
 
-	if (result == NULL)	// Promenna pro vysledek jeste nebyla definovana
+	// Promenna pro vysledek jeste nebyla definovana nebo obsahuje sdilenou konstantu
+	if (result == NULL || constantPoolContains(result))
 	{
 		// -------------- Vytvoreni nove nedefinovane promenne -----------------------
-		error = insertNewVariable(*((int *) instruction->op1));
+		error = insertNewVariable(instruction->op1.offset);
 		if (error != ERR_OK)
 			return error;
 		// -------------- Nacteni promenne vysledku ----------------------------------
-		error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+		error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 		if (error != ERR_OK)
 			return error;
 	}
@@ -843,33 +1014,34 @@ ecode instructionPower(tInstruction *instruction)
 	ecode error;
 	tVariable *result, *op1, *op2;
 
-	if (instruction->op1 == NULL || instruction->op2 == NULL || instruction->op3 == NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 == OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni promenne vysledku ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni prvniho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op2), (void **) &op1);
+	error = readOperand(instruction->kind2, instruction->op2, &op1);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni druheho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op3), (void **) &op2);
+	error = readOperand(instruction->kind3, instruction->op3, &op2);
 	if (error != ERR_OK)
 		return error;
 
 
-	if (result == NULL)	// Promenna pro vysledek jeste nebyla definovana
+	// Promenna pro vysledek jeste nebyla definovana nebo obsahuje sdilenou konstantu
+	if (result == NULL || constantPoolContains(result))
 	{
 		// -------------- Vytvoreni nove nedefinovane promenne -----------------------
-		error = insertNewVariable(*((int *) instruction->op1));
+		error = insertNewVariable(instruction->op1.offset);
 		if (error != ERR_OK)
 			return error;
 		// -------------- Nacteni promenne vysledku ----------------------------------
-		error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+		error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 		if (error != ERR_OK)
 			return error;
 	}
@@ -909,33 +1081,34 @@ ecode operationRelational(tInstruction *instruction)
 	ecode error;
 	tVariable *result, *op1, *op2;
 
-	if (instruction->op1 == NULL || instruction->op2 == NULL || instruction->op3 == NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 == OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni promenne vysledku ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni prvniho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op2), (void **) &op1);
+	error = readOperand(instruction->kind2, instruction->op2, &op1);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni druheho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op3), (void **) &op2);
+	error = readOperand(instruction->kind3, instruction->op3, &op2);
 	if (error != ERR_OK)
 		return error;
 
 
-	if (result == NULL)	// Promenna pro vysledek jeste nebyla definovana
+	// Promenna pro vysledek jeste nebyla definovana nebo obsahuje sdilenou konstantu
+	if (result == NULL || constantPoolContains(result))
 	{
 		// -------------- Vytvoreni nove nedefinovane promenne -----------------------
-		error = insertNewVariable(*((int *) instruction->op1));
+		error = insertNewVariable(instruction->op1.offset);
 		if (error != ERR_OK)
 			return error;
 		// -------------- Nacteni promenne vysledku ----------------------------------
-		error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+		error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 		if (error != ERR_OK)
 			return error;
 
@@ -987,8 +1160,15 @@ ecode operationRelational(tInstruction *instruction)
 		else if(op1->semantic == STRING)
 		{
 			// -------------- Porovnani dvou retezcu ---------------------------------
+			String *string1 = op1->value;
+			String *string2 = op2->value;
 			int comparison;
-			comparison = stringCompare(op1->value, op2->value);
+
+			// -------------- Rovnost rozhodne uz rozdilna delka -----------------
+			if (instruction->instruction == INSTR_EQUAL || instruction->instruction == INSTR_NOT_EQUAL)
+				comparison = !stringBytesEqual(string1->data, string1->length, string2->data, string2->length);
+			else
+				comparison = stringBytesCompare(string1->data, string1->length, string2->data, string2->length);
 
 			switch (instruction->instruction)
 			{
@@ -1077,30 +1257,31 @@ ecode instructionSubstring(tInstruction *instruction)
 	tRange *range;
 	int from, to;
 	// -------------- Nacteni promenne vysledku ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni prvniho operandu -----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op2), (void **) &varString);
+	error = readOperand(instruction->kind2, instruction->op2, &varString);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni druheho operandu -----------------------------------
 	// -------------- Rozsah podretezce ------------------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op3), (void **) &varRange);
+	error = readOperand(instruction->kind3, instruction->op3, &varRange);
 	if (error != ERR_OK)
 		return error;
 
 
-	if (result == NULL)	// Promenna pro vysledek jeste nebyla definovana
+	// Promenna pro vysledek jeste nebyla definovana nebo obsahuje sdilenou konstantu
+	if (result == NULL || constantPoolContains(result))
 	{
 		// -------------- Vytvoreni nove nedefinovane promenne -----------------------
-		error = insertNewVariable(*((int *) instruction->op1));
+		error = insertNewVariable(instruction->op1.offset);
 		if (error != ERR_OK)
 			return error;
 		// -------------- Nacteni promenne vysledku ----------------------------------
-		error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+		error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 		if (error != ERR_OK)
 			return error;
 	}
@@ -1120,7 +1301,7 @@ ecode instructionSubstring(tInstruction *instruction)
 	// -------------- Dolni mez retezce ------------------------------------------
 	if (range->off1 != NULL)
 	{
-		error = tRuntimeStackRead(runtimeStack, *(range->off1), (void **) &varFrom);
+		error = readRangeOperand(range->off1, &varFrom);
 		if (error != ERR_OK)
 			return error;
 
@@ -1137,7 +1318,7 @@ ecode instructionSubstring(tInstruction *instruction)
 	// -------------- Horni mez retezce ------------------------------------------
 	if (range->off2 != NULL)
 	{
-		error = tRuntimeStackRead(runtimeStack, *(range->off2), (void **) &varTo);
+		error = readRangeOperand(range->off2, &varTo);
 		if (error != ERR_OK)
 			return error;
 
@@ -1164,36 +1345,25 @@ ecode instructionSubstring(tInstruction *instruction)
 }
 
 /**
- * Vlozeni kopie promenne z op1 na vrchol zasobniku
+ * Vlozeni konstanty z op1 na vrchol zasobniku. Konstanta se nekopiruje,
+ * na zasobniku je sdilena hodnota z tabulky konstant
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
 ecode instructionPush(tInstruction *instruction)
 {
-	ecode error;
-	tVariable *newVar;
-	if (instruction->op1 == NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 != OPERAND_CONSTANT || instruction->kind2 != OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 	{
 		return ERR_INSTR_WRONG_OPERANDS;
 	}
 
-	// -------------- Vytvoreni kopie promenne -----------------------------------
-	error = copyVariable(instruction->op1, &newVar);
-	if (error != ERR_OK)
-		return error;
-
-	// -------------- Vlozeni promenne na zasobnik -------------------------------
-	error = tRuntimeStackPush(runtimeStack, newVar);
-	if (error != ERR_OK)
-	{
-		freeVariable(&newVar);
-		return error;
-	}
-	return ERR_OK;
+	// -------------- Vlozeni konstanty na zasobnik ------------------------------
+	return tRuntimeStackPush(runtimeStack, constantPoolValue(instruction->op1.constant));
 }
 
 /**
- * Vlozeni kopie promenne ulozene na offsetu op1 v zasobniku na vrchol zasobniku
+ * Vlozeni kopie promenne ulozene na offsetu op1 v zasobniku (nebo konstanty)
+ * na vrchol zasobniku
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
@@ -1202,13 +1372,13 @@ ecode instructionPushStack(tInstruction *instruction)
 	ecode error;
 	tVariable *varToPush, *varSrc;
 
-	if (instruction->op1 == NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 != OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 	{
 		return ERR_INSTR_WRONG_OPERANDS;
 	}
 
 	// -------------- Nacteni promenne pro vlozeni na zasobnik -------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &varSrc);
+	error = readOperand(instruction->kind1, instruction->op1, &varSrc);
 	if (error != ERR_OK)
 		return error;
 
@@ -1239,7 +1409,7 @@ ecode instructionPop(tInstruction *instruction)
 	ecode error;
 	tVariable *varPopped, *varResult, *tmp;
 
-	if (instruction->op1 == NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 != OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 	{
 		return ERR_INSTR_WRONG_OPERANDS;
 	}
@@ -1250,20 +1420,21 @@ ecode instructionPop(tInstruction *instruction)
 		return error;
 
 	// -------------- Nacteni promenne pro ulozeni vrcholu zasobniku -------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &varResult);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &varResult);
 	if (error)
 		return error;
 
 
-	if (varResult == NULL)	// Promenna pro vysledek jeste nebyla definovana
+	// Promenna pro vysledek jeste nebyla definovana nebo obsahuje sdilenou konstantu
+	if (varResult == NULL || constantPoolContains(varResult))
 	{
 		// -------------- Vytvoreni nove nedefinovane promenne -----------------------
-		error = insertNewVariable(*((int *) instruction->op1));
+		error = insertNewVariable(instruction->op1.offset);
 		if (error)
 			return error;
 
 		// -------------- Nacteni promenne vysledku ----------------------------------
-		error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &varResult);
+		error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &varResult);
 		if (error)
 			return error;
 	}
@@ -1302,29 +1473,29 @@ ecode instructionMov(tInstruction *instruction)
 {
 	ecode error;
 	tVariable *result;
-	if (instruction->op1 == NULL || instruction->op2 == NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 	{
 		return ERR_INSTR_WRONG_OPERANDS;
 	}
 
 	// -------------- Nacteni promenne vysledku ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 	if (error != ERR_OK)
 		return error;
 
 	if (result != NULL)	// Promenna pro vysledek jiz byla definovana
 	{
 		// Uvolneni promenne
-		freeVariable(&result);
+		releaseVariable(&result);
 	}
 
 	// -------------- Vytvoreni kopie promenne -----------------------------------
-	error = copyVariable(instruction->op2, &result);
+	error = copyVariable(instruction->op2.pointer, &result);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Vlozeni promenne na zasobnik -------------------------------
-	error = tRuntimeStackInsert(runtimeStack, *((int *) instruction->op1), result);
+	error = tRuntimeStackInsert(runtimeStack, instruction->op1.offset, result);
 	if (error != ERR_OK)
 	{
 		freeVariable(&result);
@@ -1334,7 +1505,7 @@ ecode instructionMov(tInstruction *instruction)
 }
 
 /**
- * Kopie promenne *tVraible z offsetu op2 na offset op1
+ * Kopie promenne *tVraible z offsetu op2 (nebo konstanty) na offset op1
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
@@ -1342,18 +1513,18 @@ ecode instructionMovStack(tInstruction *instruction)
 {
 	ecode error;
 	tVariable *result, *srcVar;
-	if (instruction->op1 == NULL || instruction->op2 == NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 	{
 		return ERR_INSTR_WRONG_OPERANDS;
 	}
 
 	// -------------- Nacteni promenne vysledku ----------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &result);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &result);
 	if (error != ERR_OK)
 		return error;
 
 	// -------------- Nacteni promenne pro kopirovani ----------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op2), (void **) &srcVar);
+	error = readOperand(instruction->kind2, instruction->op2, &srcVar);
 	if (error != ERR_OK)
 		return error;
 
@@ -1365,9 +1536,9 @@ ecode instructionMovStack(tInstruction *instruction)
 
 	if (result != NULL)	// Promenna pro vysledek jiz byla definovana
 	{
-		freeVariable(&result);
+		releaseVariable(&result);
 		// -------------- Vlozeni NULL na zasobnik -----------------------------------
-		error = tRuntimeStackInsert(runtimeStack, *((int *) instruction->op1), NULL);
+		error = tRuntimeStackInsert(runtimeStack, instruction->op1.offset, NULL);
 		if (error != ERR_OK)
 			return error;
 	}
@@ -1378,7 +1549,7 @@ ecode instructionMovStack(tInstruction *instruction)
 		return error;
 
 	// -------------- Vlozeni promenne na zasobnik -------------------------------
-	error = tRuntimeStackInsert(runtimeStack, *((int *) instruction->op1), result);
+	error = tRuntimeStackInsert(runtimeStack, instruction->op1.offset, result);
 	if (error != ERR_OK)
 	{
 		freeVariable(&result);
@@ -1397,20 +1568,20 @@ ecode instructionRemoveStack(tInstruction *instruction)
 	ecode error;
 	tVariable *target;
 
-	if (instruction->op1 == NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 != OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 	{
 		return ERR_INSTR_WRONG_OPERANDS;
 	}
 
 	// -------------- Nacteni mazane promenne ------------------------------------
-	error = tRuntimeStackRead(runtimeStack, *((int *) instruction->op1), (void **) &target);
+	error = tRuntimeStackRead(runtimeStack, instruction->op1.offset, (void **) &target);
 	if (error != ERR_OK)
 		return error;
 
-	freeVariable(&target);
+	releaseVariable(&target);
 
 	// -------------- Vlozeni NULL na zasobnik -----------------------------------
-	error = tRuntimeStackInsert(runtimeStack, *((int *) instruction->op1), NULL);
+	error = tRuntimeStackInsert(runtimeStack, instruction->op1.offset, NULL);
 	if (error != ERR_OK)
 		return error;
 
@@ -1419,6 +1590,7 @@ ecode instructionRemoveStack(tInstruction *instruction)
 
 /**
  * Provedeni vestavene fce input(), nacteni radky s escape sekvencemi ze stdin
+ * Vysledek se ulozi na offset op1
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
@@ -1426,15 +1598,14 @@ ecode instructionInput(tInstruction *instruction)
 {
 	ecode error;
     int c;
-	tVariable *target;
     String *inputString = NULL;
 
-	if (instruction->op1 != NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 != OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
-    // -------------- Nacteni navratobe hodnoty -------------------------------
-    error = tRuntimeStackRead(runtimeStack, -2, (void **) &target);
-    if (error != ERR_OK) return error;
+	// -------------- Vypis bufferu pred ctenim vstupu ------------------------
+	error = outputBufferFlush();
+	if (error != ERR_OK) return error;
 
 	// -------------- Nacteni radky ze stdin ----------------------------------
 	inputString = charToString(""); // Nastaveti prazdneho retezce
@@ -1450,16 +1621,15 @@ ecode instructionInput(tInstruction *instruction)
         if (inputString == NULL) return ERR_MEMORY;
     }
 
-    // -------------- Nastaveni vysledku do navratove hodnoty -----------------
-    target->value = inputString;
-    target->semantic = STRING;
-
-    return ERR_OK;
+    // -------------- Nastaveni vysledku --------------------------------------
+    return storeResult(instruction->op1.offset, STRING, inputString);
 }
 
 /**
  * Provedeni vestavene funkce numeric(), prevod retezce na cislo double vyuziva
- * fce stringToDouble, ignoruje pocatecni bile znaky nasledne prevadi cislo
+ * fce numberParse pro bezne tvary cisel a stringToDouble pro ostatni,
+ * ignoruje pocatecni bile znaky nasledne prevadi cislo
+ * Parametr je operand op2, vysledek se ulozi na offset op1
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
@@ -1467,24 +1637,19 @@ ecode instructionNumeric(tInstruction *instruction)
 {
 	ecode error;
 	int success;
-	tVariable *target;
 	tVariable *arg;
 	double *retValue;
 
-	if (instruction->op1 != NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni parametru ---------------------------------------
-	error = tRuntimeStackRead(runtimeStack, -3, (void **) &arg);
+	error = readOperand(instruction->kind2, instruction->op2, &arg);
 	if (error != ERR_OK) return error;
 	else if (arg == NULL) return ERR_RUNTIME_OTHER;
 
-	// -------------- Nacteni navratobe hodnoty -------------------------------
-	error = tRuntimeStackRead(runtimeStack, -2, (void **) &target);
-	if (error != ERR_OK) return error;
-
 	// -------------- Alokace mista pro navratovou hodnotu --------------------
-	retValue = (double *) malloc(sizeof(double));
+	retValue = (double *) variablePoolAlloc(sizeof(double));
 	if (retValue == NULL) return ERR_MEMORY;
 
 	// -------------- Provedeni funkce ----------------------------------------
@@ -1492,63 +1657,55 @@ ecode instructionNumeric(tInstruction *instruction)
 	{
 		case NIL:
 		case LOGICAL:
-			free(retValue);
+			variablePoolRelease(retValue);
 			return ERR_RUNTIME_NUMERIC_CONVERSION;
 			break;
 		case NUMERIC:
 			*retValue = *((double *)arg->value);
 			break;
 		case STRING:
-			success = stringToDouble((String *) arg->value, retValue);
+			// Bezne tvary cisel se prevedou primo, ostatni obecnou funkci
+			success = numberParse(((String *) arg->value)->data, ((String *) arg->value)->length, retValue);
+			if (!success)
+				success = stringToDouble((String *) arg->value, retValue);
 			if (!success)
 			{
-				free(retValue);
+				variablePoolRelease(retValue);
 				return ERR_RUNTIME_NUMERIC_CONVERSION;
 			}
 
 			break;
 		default:
-			free(retValue);
+			variablePoolRelease(retValue);
 			return ERR_INTERNAL;
 			break;
 	}
 
-	// -------------- Nastaveni vysledku do navratove hodnoty -----------------
-	target->value = retValue;
-	target->semantic = NUMERIC;
-
-	return ERR_OK;
+	// -------------- Nastaveni vysledku --------------------------------------
+	return storeResult(instruction->op1.offset, NUMERIC, retValue);
 }
 
 /**
- * Provede vestavenou funkci print, nacita parametry ze zasobniku podle
- * poctu vlozenem v prvnim parametru a tiskne na stdout.
+ * Provede vestavenou funkci print, vypisuje parametry ze seznamu operandu
+ * v op2 do vystupniho bufferu. Na offset op1 ulozi vysledek nil
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
 ecode instructionPrint(tInstruction *instruction)
 {
 	ecode error;
-	int argCount;
-	tVariable *numOfArgs;
+	tOperandArray *args;
 	tVariable *arg;
-	int offset = -3;
 
-	if (instruction->op1 != NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
-	// -------------- Nacteni poctu parametru ---------------------------------
-	error = tRuntimeStackRead(runtimeStack, offset, (void **) &numOfArgs);
-	if (error != ERR_OK) return error;
-	else if (numOfArgs == NULL) return ERR_INTERNAL;
-
-	argCount = *((double *)numOfArgs->value);
+	args = instruction->op2.pointer;
 
 	// -------------- Nacitani parametru a provadeni vypisu -------------------
-	for (int i = -argCount + offset ; i < offset; i++)
+	for (int i = 0; i < args->count; i++)
 	{
-		// argOffset = argOffset - i;
-		error = tRuntimeStackRead(runtimeStack, i, (void **) &arg);
+		error = readOperand(args->operands[i].kind, args->operands[i].operand, &arg);
 		if (error != ERR_OK) return error;
 		else if (arg == NULL) return ERR_RUNTIME_OTHER;
 
@@ -1556,55 +1713,53 @@ ecode instructionPrint(tInstruction *instruction)
 		switch (arg->semantic)
 		{
 			case NIL:
-				printf("Nil");
+				error = outputBufferWrite("Nil", 3);
 				break;
 			case LOGICAL:
 				if (*((bool *)arg->value) == true)
-					printf("true");
+					error = outputBufferWrite("true", 4);
 				else
-					printf("false");
+					error = outputBufferWrite("false", 5);
 				break;
 			case NUMERIC:
-					printf("%g", *((double *)arg->value));
+					error = outputBufferWriteNumber(*((double *)arg->value));
 				break;
 			case STRING:
-					printf("%s", ((String *)arg->value)->data);
+					error = outputBufferWrite(((String *)arg->value)->data, ((String *)arg->value)->length);
 				break;
 			default:
 				return ERR_INTERNAL;
 				break;
 		}
+		if (error != ERR_OK) return error;
 	}
 
-	return ERR_OK;
+	// -------------- Funkce print vraci nil ----------------------------------
+	return storeResult(instruction->op1.offset, NIL, NULL);
 }
 
 /**
  * Provede vestavenou fuknci typeOf(), vraci double do promenne na offset vysledku
+ * Parametr je operand op2, vysledek se ulozi na offset op1
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
 ecode instructionTypeOf(tInstruction *instruction)
 {
 	ecode error;
-	tVariable *target;
 	tVariable *arg;
 	double *retValue;
 
-	if (instruction->op1 != NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni parametru ---------------------------------------
-	error = tRuntimeStackRead(runtimeStack, -3, (void **) &arg);
+	error = readOperand(instruction->kind2, instruction->op2, &arg);
 	if (error != ERR_OK) return error;
 	else if (arg == NULL) return ERR_RUNTIME_OTHER;
 
-	// -------------- Nacteni navratove hodnoty -------------------------------
-	error = tRuntimeStackRead(runtimeStack, -2, (void **) &target);
-	if (error != ERR_OK) return error;
-
 	// -------------- Alokace mista pro navratovou hodnotu --------------------
-	retValue = (double *) malloc(sizeof(double));
+	retValue = (double *) variablePoolAlloc(sizeof(double));
 	if (retValue == NULL) return ERR_MEMORY;
 
 	switch (arg->semantic)
@@ -1625,45 +1780,38 @@ ecode instructionTypeOf(tInstruction *instruction)
 			*retValue = 8.0;
 			break;
 		default:
-			free(retValue);
+			variablePoolRelease(retValue);
 			return ERR_INTERNAL;
 			break;
 	}
 
-	// -------------- Nastaveni vysledku do navratove hodnoty -----------------
-	target->value = retValue;
-	target->semantic = NUMERIC;
-
-	return ERR_OK;
+	// -------------- Nastaveni vysledku --------------------------------------
+	return storeResult(instruction->op1.offset, NUMERIC, retValue);
 }
 
 /**
  * Provede vestavenou funkci len(), nastavuje delku retezce typu double do
  * promenne na offset vysledku
+ * Parametr je operand op2, vysledek se ulozi na offset op1
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
 ecode instructionLen(tInstruction *instruction)
 {
 	ecode error;
-	tVariable *target;
 	tVariable *arg;
 	double *retValue = NULL;
 
-	if (instruction->op1 != NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni parametru ---------------------------------------
-	error = tRuntimeStackRead(runtimeStack, -3, (void **) &arg);
+	error = readOperand(instruction->kind2, instruction->op2, &arg);
 	if (error != ERR_OK) return error;
 	else if (arg == NULL) return ERR_RUNTIME_OTHER;
 
-	// -------------- Nacteni navratobe hodnoty -------------------------------
-	error = tRuntimeStackRead(runtimeStack, -2, (void **) &target);
-	if (error != ERR_OK) return error;
-
 	// -------------- Alokace mista pro navratovou hodnotu --------------------
-	retValue = (double *) malloc(sizeof(double));
+	retValue = (double *) variablePoolAlloc(sizeof(double));
 	if (retValue == NULL) return ERR_MEMORY;
 
 	// -------------- Vypocet delky retezce -----------------------------------
@@ -1671,37 +1819,43 @@ ecode instructionLen(tInstruction *instruction)
 		*retValue = (double) stringLength(arg->value);
 	else
 		*retValue = 0.0;
-	// -------------- Nastaveni vysledku do navratove hodnoty -----------------
-	target->semantic = NUMERIC;
-	target->value = retValue;
 
-	return ERR_OK;
+	// -------------- Nastaveni vysledku --------------------------------------
+	return storeResult(instruction->op1.offset, NUMERIC, retValue);
 }
 
 /**
  * Provede vestavenou funkci find(), nastavuje pozici vyskytu prvniho znaku
  * podretezce v hledanem retezci do promenne na offset vysledku vyuziva funkci
- * find z ial.h
+ * stringSearch ze string_ops.h, pro konstantni podretezec tabulku posunu
+ * z op3 vytvorenou pri prekladu mista volani
+ * Parametry jsou v seznamu operandu op2, vysledek se ulozi na offset op1
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
 ecode instructionFind(tInstruction *instruction)
 {
 	ecode error;
-	tVariable *target;
+	tOperandArray *args;
+	tSearchTable *searchTable;
 	tVariable *arg1;
 	tVariable *arg2;
 	double *retValue;
 
-	if (instruction->op1 != NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE)
+		return ERR_INSTR_WRONG_OPERANDS;
+
+	args = instruction->op2.pointer;
+	searchTable = instruction->op3.pointer;
+	if (args->count != 2)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni parametru ---------------------------------------
-	error = tRuntimeStackRead(runtimeStack, -4, (void **) &arg1);
+	error = readOperand(args->operands[0].kind, args->operands[0].operand, &arg1);
 	if (error != ERR_OK) return error;
 	else if (arg1 == NULL) return ERR_RUNTIME_OTHER;
 
-	error = tRuntimeStackRead(runtimeStack, -3, (void **) &arg2);
+	error = readOperand(args->operands[1].kind, args->operands[1].operand, &arg2);
 	if (error != ERR_OK) return error;
 	else if (arg2 == NULL) return ERR_RUNTIME_OTHER;
 
@@ -1709,40 +1863,40 @@ ecode instructionFind(tInstruction *instruction)
 	if (arg1->semantic != STRING || arg2->semantic != STRING)
 		return ERR_RUNTIME_INCOMPATIBLE_TYPES;
 
-	// -------------- Nacteni navratobe hodnoty -------------------------------
-	error = tRuntimeStackRead(runtimeStack, -2, (void **) &target);
-	if (error != ERR_OK) return error;
-
-		// -------------- Alokace mista pro navratovou hodnotu --------------------
-	retValue = (double *) malloc(sizeof(double));
+	// -------------- Alokace mista pro navratovou hodnotu --------------------
+	retValue = (double *) variablePoolAlloc(sizeof(double));
 	if (retValue == NULL) return ERR_MEMORY;
 
-	*retValue = (double) find((String *) arg1->value, (String *) arg2->value);
-
-	target->semantic = NUMERIC;
-	target->value = retValue;
+	// -------------- Konstantni podretezec ma tabulku z mista volani ---------
+	if (searchTable != NULL)
+		*retValue = (double) searchTableFind(searchTable, ((String *) arg1->value)->data, ((String *) arg1->value)->length);
+	else
+		*retValue = (double) stringSearch(((String *) arg1->value)->data, ((String *) arg1->value)->length,
+		                                  ((String *) arg2->value)->data, ((String *) arg2->value)->length);
 
-	return ERR_OK;
+	// -------------- Nastaveni vysledku --------------------------------------
+	return storeResult(instruction->op1.offset, NUMERIC, retValue);
 }
 
 /**
- * Provede vestavenou funkci sort(), pomoci funkce sort() z ial.h (quicksort)
+ * Provede vestavenou funkci sort(), razeni pocitanim vyskytu znaku
+ * pomoci funkce stringSortBytes() ze string_ops.h
+ * Parametr je operand op2, vysledek se ulozi na offset op1
  * @param *instruction Ukazatel na provadenou instrukci
  * @return ERR_OK pokud nenastala zadana chyba, jinak chybovy kod
  */
 ecode instructionSort(tInstruction *instruction)
 {
 	ecode error;
-	tVariable *target;
 	tVariable *arg;
 	String *retValue;
 
 
-	if (instruction->op1 != NULL || instruction->op2 != NULL || instruction->op3 != NULL)
+	if (instruction->kind1 == OPERAND_NONE || instruction->kind2 == OPERAND_NONE || instruction->kind3 != OPERAND_NONE)
 		return ERR_INSTR_WRONG_OPERANDS;
 
 	// -------------- Nacteni parametru ---------------------------------------
-	error = tRuntimeStackRead(runtimeStack, -3, (void **) &arg);
+	error = readOperand(instruction->kind2, instruction->op2, &arg);
 	if (error != ERR_OK)
 		return error;
 	else if (arg == NULL)
@@ -1750,19 +1904,14 @@ ecode instructionSort(tInstruction *instruction)
 	else if (arg->semantic != STRING)
 		return ERR_RUNTIME_INCOMPATIBLE_TYPES;
 
-	// -------------- Nacteni navratobe hodnoty -------------------------------
-	error = tRuntimeStackRead(runtimeStack, -2, (void **) &target);
-
 	// -------------- Vytvoreni kopie retezce ---------------------------------
 	retValue = stringCopy((String *) arg->value);
-
-	// -------------- Provedeni razeni ----------------------------------------
-	retValue = sort(retValue);
 	if (retValue == NULL)
-		return ERR_INTERNAL;
+		return ERR_MEMORY;
 
-	target->semantic = STRING;
-	target->value = retValue;
+	// -------------- Provedeni razeni primo v kopii --------------------------
+	stringSortBytes(retValue->data, retValue->length);
 
-	return ERR_OK;
+	// -------------- Nastaveni vysledku --------------------------------------
+	return storeResult(instruction->op1.offset, STRING, retValue);
 }
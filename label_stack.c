@@ -15,32 +15,41 @@
 tLabelStack* tLabelStackInit()
 {
 	tLabelStack *stack;
-	stack = malloc(sizeof(stack));
+	stack = malloc(sizeof(tLabelStack));
 	if (stack == NULL) // Nedostatek pameti
 		return NULL;
 
+	stack->items = malloc(LABEL_STACK_ALLOC_STEP * sizeof(int));
+	if (stack->items == NULL)
+	{
+		free(stack);
+		return NULL;
+	}
+
 	// Inicializace stacku
-	stack->top = NULL;
+	stack->top = -1;
+	stack->size = LABEL_STACK_ALLOC_STEP;
 
 	return stack;
 }
-// Vlozi na vrchol zasobniku predana data, pokud je vse v poradku vrati ERR_OK
-int tLabelStackPush(tLabelStack *stack, void *data)
+// Vlozi na vrchol zasobniku cislo navesti, pokud je vse v poradku vrati ERR_OK
+int tLabelStackPush(tLabelStack *stack, int label)
 {
 	if (stack == NULL)
 		return ERR_NULL;
 
-	tLabelStackItem *newItem;	// Nova polozka zasobniku
+	// Plne pole se zdvojnasobi
+	if (stack->top + 1 == stack->size)
+	{
+		int *newItems = realloc(stack->items, 2 * stack->size * sizeof(int));
+		if (newItems == NULL)
+			return ERR_MEMORY;
 
-	// Alokace pameti pro novou polozku
-	newItem = malloc(sizeof(tLabelStackItem));
-	if (newItem == NULL)
-		return ERR_MEMORY;
+		stack->items = newItems;
+		stack->size *= 2;
+	}
 
-	// Nastaveni nove polozky
-	newItem->data = data;
-	newItem->prev = stack->top;
-	stack->top = newItem;
+	stack->items[++stack->top] = label;
 
 	return ERR_OK;
 }
@@ -48,42 +57,113 @@ int tLabelStackPush(tLabelStack *stack, void *data)
 // Odstrani polozku na vrcholu zasobniku
 void tLabelStackPop(tLabelStack *stack)
 {
-	tLabelStackItem *tmpItem;
 	if (stack == NULL)
 		return;
 
-
-	if (stack->top != NULL)
+	if (stack->top >= 0)
 	{	// Zasobnik neni prazdny
-		tmpItem = stack->top->prev;
-		free(stack->top);
-		stack->top = tmpItem;
+		stack->top--;
 	}
 }
-// Vrati data ulozena na vrcholu zasobniku
-void *tLabelStackTop(tLabelStack *stack)
+// Vrati cislo navesti na vrcholu zasobniku
+int tLabelStackTop(tLabelStack *stack)
 {
 	if (stack == NULL)
-		return NULL;
+		return -1;
 	// Prazdny zasobnik
-	if (stack->top == NULL)
-		return NULL;
+	if (stack->top < 0)
+		return -1;
 
-	return stack->top->data;
+	return stack->items[stack->top];
 }
 // Uvolni zasobnik
 void tLabelStackFree(tLabelStack *stack)
 {
 	if (stack == NULL)
 		return;
-	tLabelStackItem *tmpItem;
 
-	while (stack->top != NULL)
+	free(stack->items);
+	free(stack);
+}
+
+// Inicializace prazdne tabulky navesti
+void tLabelTableInit(tLabelTable *table)
+{
+	table->targets = NULL;
+	table->count = table->size = 0;
+	table->jumps = NULL;
+	table->jumpCount = table->jumpSize = 0;
+}
+
+// Vytvoreni noveho navesti
+ecode tLabelTableNew(tLabelTable *table, int *label)
+{
+	if (table->count == table->size)
 	{
-		tmpItem = stack->top->prev;
-		free(stack->top);
-		stack->top = tmpItem;
+		int newSize = table->size ? 2 * table->size : LABEL_STACK_ALLOC_STEP;
+		tIListItem **newTargets = realloc(table->targets, newSize * sizeof(tIListItem *));
+		if (newTargets == NULL)
+			return ERR_MEMORY;
+
+		table->targets = newTargets;
+		table->size = newSize;
 	}
 
-	free(stack);
+	table->targets[table->count] = NULL;
+	*label = table->count++;
+	return ERR_OK;
+}
+
+// Prirazeni instrukce navesti
+void tLabelTableSet(tLabelTable *table, int label, tIListItem *target)
+{
+	table->targets[label] = target;
+}
+
+// Zaznam skoku na navesti
+ecode tLabelTableAddJump(tLabelTable *table, tInstruction *instruction, int label)
+{
+	if (table->jumpCount == table->jumpSize)
+	{
+		int newSize = table->jumpSize ? 2 * table->jumpSize : LABEL_STACK_ALLOC_STEP;
+		tLabelJump *newJumps = realloc(table->jumps, newSize * sizeof(tLabelJump));
+		if (newJumps == NULL)
+			return ERR_MEMORY;
+
+		table->jumps = newJumps;
+		table->jumpSize = newSize;
+	}
+
+	table->jumps[table->jumpCount].instruction = instruction;
+	table->jumps[table->jumpCount].label = label;
+	table->jumpCount++;
+	return ERR_OK;
+}
+
+// Doplneni cilu skoku a vyprazdneni tabulky
+ecode tLabelTableResolve(tLabelTable *table)
+{
+	tIListItem *target;
+
+	for (int i = 0; i < table->jumpCount; i++)
+	{
+		target = table->targets[table->jumps[i].label];
+		if (target == NULL)
+			return ERR_INTERNAL;
+
+		table->jumps[i].instruction->kind1 = OPERAND_POINTER;
+		table->jumps[i].instruction->op1.pointer = target;
+	}
+
+	table->count = 0;
+	table->jumpCount = 0;
+	return ERR_OK;
+}
+
+// Uvolneni poli tabulky navesti
+void tLabelTableFree(tLabelTable *table)
+{
+	free(table->targets);
+	free(table->jumps);
+	tLabelTableInit(table);
 }
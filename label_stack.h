@@ -10,26 +10,93 @@
 #ifndef LABEL_STACK_H
 #define LABEL_STACK_H
 
-typedef struct labelStackItem
-{
-	struct labelStackItem* prev;
-	void *data;
-} tLabelStackItem;
+#include "errnum.h"
+#include "ilist.h"
+
+// Pocatecni velikost pole zasobniku, pri zaplneni se zdvojnasobi
+#define LABEL_STACK_ALLOC_STEP 16
 
+// Navesti je cislo v tabulce navesti prave prekladane funkce
 typedef struct
 {
-	tLabelStackItem *top;
+	int *items;		// Souvisle pole cisel navesti
+	int top;		// Index vrcholu, -1 pro prazdny zasobnik
+	int size;		// Velikost alokovaneho pole
 } tLabelStack;
 
+// Skok, kteremu se po prekladu funkce doplni instrukce navesti
+typedef struct
+{
+	tInstruction *instruction;	// Instrukce INSTR_GOTO nebo INSTR_IFGOTO
+	int label;					// Cislo ciloveho navesti
+} tLabelJump;
+
+// Tabulka navesti jedne funkce
+typedef struct
+{
+	tIListItem **targets;	// Instrukce navesti podle cisla navesti
+	int count;				// Pocet navesti
+	int size;				// Velikost pole navesti
+	tLabelJump *jumps;		// Skoky cekajici na doplneni
+	int jumpCount;			// Pocet skoku
+	int jumpSize;			// Velikost pole skoku
+} tLabelTable;
+
 // Konstruktor pro tLabelStack
 tLabelStack* tLabelStackInit();
-// Vlozi na vrchol zasobniku predana data, pokud je vse v poradku vrati ERR_OK
-int tLabelStackPush(tLabelStack *stack, void *data);
+// Vlozi na vrchol zasobniku cislo navesti, pokud je vse v poradku vrati ERR_OK
+int tLabelStackPush(tLabelStack *stack, int label);
 // Odstrani polozku na vrcholu zasobniku
 void tLabelStackPop(tLabelStack *stack);
-// Vrati data ulozena na vrcholu zasobniku
-void *tLabelStackTop(tLabelStack *stack);
+// Vrati cislo navesti na vrcholu zasobniku, -1 pro prazdny zasobnik
+int tLabelStackTop(tLabelStack *stack);
 // Uvolni zasobnik
 void tLabelStackFree(tLabelStack *stack);
 
+/**
+ * Inicializace prazdne tabulky navesti
+ * @param  table Ukazatel na tabulku
+ */
+void tLabelTableInit(tLabelTable *table);
+
+/**
+ * Vytvoreni noveho navesti bez instrukce
+ * @param  table Ukazatel na tabulku
+ * @param  label Ukazatel pro ulozeni cisla navesti
+ * @return       ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+ecode tLabelTableNew(tLabelTable *table, int *label);
+
+/**
+ * Prirazeni instrukce navesti
+ * @param  table  Ukazatel na tabulku
+ * @param  label  Cislo navesti
+ * @param  target Instrukce, na kterou navesti ukazuje
+ */
+void tLabelTableSet(tLabelTable *table, int label, tIListItem *target);
+
+/**
+ * Zaznam skoku na navesti, cil se doplni funkci tLabelTableResolve
+ * @param  table       Ukazatel na tabulku
+ * @param  instruction Instrukce skoku
+ * @param  label       Cislo ciloveho navesti
+ * @return             ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+ecode tLabelTableAddJump(tLabelTable *table, tInstruction *instruction, int label);
+
+/**
+ * Doplneni instrukci navesti do vsech zaznamenanych skoku (op1 bude
+ * tIListItem *) a vyprazdneni tabulky pro dalsi funkci
+ * @param  table Ukazatel na tabulku
+ * @return       ERR_OK pokud je vse v poradku, ERR_INTERNAL pro skok
+ *               na navesti bez instrukce
+ */
+ecode tLabelTableResolve(tLabelTable *table);
+
+/**
+ * Uvolneni poli tabulky navesti
+ * @param  table Ukazatel na tabulku
+ */
+void tLabelTableFree(tLabelTable *table);
+
 #endif // LABEL_STACK_H
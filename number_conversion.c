@@ -0,0 +1,244 @@
+// number_conversion.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Conversions between numbers and their textual representation              *
+ ******************************************************************************
+ */
+#include "number_conversion.h"
+#include <math.h>
+#include <stdio.h>
+
+// Pocet platnych cislic formatu %g
+#define FORMAT_PRECISION 6
+// Nejvetsi cislo s FORMAT_PRECISION cislicemi + 1
+#define FORMAT_DIGITS_LIMIT 1000000
+// Mocniny deseti, ktere lze v double vyjadrit presne
+#define EXACT_POWERS_COUNT 23
+// Pocet cislic, ktere se vzdy presne vejdou do mantisy double
+#define PARSE_MAX_DIGITS 15
+
+static const double exactPowersOfTen[EXACT_POWERS_COUNT] =
+{
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+	1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+	1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * Zapis nezaporneho celeho cisla do bufferu
+ * @param  number Zapisovane cislo
+ * @param  buffer Cilovy buffer
+ * @return        Pocet zapsanych znaku
+ */
+static int writeInteger(unsigned int number, char *buffer)
+{
+	char digits[10];
+	int count = 0;
+	int i;
+
+	do
+	{
+		digits[count++] = '0' + number % 10;
+		number /= 10;
+	} while (number != 0);
+
+	for (i = 0; i < count; i++)
+		buffer[i] = digits[count - i - 1];
+
+	return count;
+}
+
+/**
+ * Zaokrouhleni kladneho cisla na FORMAT_PRECISION platnych cislic
+ * @param  value    Zaokrouhlovane cislo
+ * @param  exponent Desitkovy exponent prvni cislice
+ * @param  digits   Ukazatel pro ulozeni cislic jako celeho cisla
+ * @return          1 pokud je zaokrouhleni jiste, 0 pokud lezi prilis blizko
+ *                  poloviny nebo je exponent mimo presne mocniny deseti
+ */
+static int roundToPrecision(double value, int exponent, unsigned int *digits)
+{
+	int scale = FORMAT_PRECISION - 1 - exponent;
+	double scaled, fraction;
+
+	// Nasobeni i deleni presnou mocninou deseti zpusobi jedine zaokrouhleni
+	if (scale >= 0 && scale < EXACT_POWERS_COUNT)
+		scaled = value * exactPowersOfTen[scale];
+	else if (scale < 0 && -scale < EXACT_POWERS_COUNT)
+		scaled = value / exactPowersOfTen[-scale];
+	else
+		return 0;
+
+	// Chyba vypoctu je mensi nez 1e-9, blizko poloviny nelze rozhodnout
+	fraction = scaled - floor(scaled);
+	if (fabs(fraction - 0.5) < 1e-9)
+		return 0;
+
+	*digits = (unsigned int) floor(scaled + 0.5);
+	return 1;
+}
+
+// Prevod cisla na retezec ve formatu %g
+int numberFormat(double value, char *buffer)
+{
+	char *position = buffer;
+	double original = value;
+	unsigned int digits;
+	int exponent;
+	int fractionDigits;
+	int i;
+
+	// Nekonecno a NaN
+	if (!isfinite(value))
+		return snprintf(buffer, NUMBER_FORMAT_MAX_LENGTH, "%g", value);
+
+	if (signbit(value))
+	{
+		*position++ = '-';
+		value = -value;
+	}
+
+	// -------------- Cela cisla do 6 cislic ------------------------------------
+	if (value < FORMAT_DIGITS_LIMIT && value == (double) (unsigned int) value)
+	{
+		position += writeInteger((unsigned int) value, position);
+		*position = '\0';
+		return position - buffer;
+	}
+
+	// -------------- Urceni exponentu a zaokrouhleni ---------------------------
+	exponent = (int) floor(log10(value));
+	if (!roundToPrecision(value, exponent, &digits))
+		return snprintf(buffer, NUMBER_FORMAT_MAX_LENGTH, "%g", original);
+
+	// Odhad exponentu z log10 muze byt o jedna vedle
+	if (digits < FORMAT_DIGITS_LIMIT / 10)
+	{
+		exponent--;
+		if (!roundToPrecision(value, exponent, &digits))
+			return snprintf(buffer, NUMBER_FORMAT_MAX_LENGTH, "%g", original);
+	}
+	if (digits >= FORMAT_DIGITS_LIMIT)
+	{
+		// Zaokrouhleni nahoru na dalsi mocninu deseti
+		exponent++;
+		digits /= 10;
+	}
+
+	// -------------- Odstraneni nevyznamnych nul -------------------------------
+	fractionDigits = FORMAT_PRECISION - 1;
+	while (fractionDigits > 0 && digits % 10 == 0)
+	{
+		digits /= 10;
+		fractionDigits--;
+	}
+
+	if (exponent < -4 || exponent >= FORMAT_PRECISION)
+	{
+		// -------------- Semilogaritmicky tvar d.ddddde+XX ----------------------
+		char mantissa[10];
+		int length = writeInteger(digits, mantissa);
+
+		*position++ = mantissa[0];
+		if (length > 1)
+		{
+			*position++ = '.';
+			for (i = 1; i < length; i++)
+				*position++ = mantissa[i];
+		}
+
+		*position++ = 'e';
+		if (exponent < 0)
+		{
+			*position++ = '-';
+			exponent = -exponent;
+		}
+		else
+			*position++ = '+';
+
+		if (exponent < 10)
+			*position++ = '0';
+		position += writeInteger(exponent, position);
+	}
+	else if (exponent >= 0)
+	{
+		// -------------- Desetinny tvar s celou casti --------------------------
+		char number[10];
+		int length = writeInteger(digits, number);
+		int integerDigits = exponent + 1;
+
+		for (i = 0; i < integerDigits; i++)
+			*position++ = i < length ? number[i] : '0';
+
+		if (length > integerDigits)
+		{
+			*position++ = '.';
+			for (i = integerDigits; i < length; i++)
+				*position++ = number[i];
+		}
+	}
+	else
+	{
+		// -------------- Desetinny tvar mensi nez jedna ------------------------
+		*position++ = '0';
+		*position++ = '.';
+		for (i = exponent + 1; i < 0; i++)
+			*position++ = '0';
+		position += writeInteger(digits, position);
+	}
+
+	*position = '\0';
+	return position - buffer;
+}
+
+// Rychly prevod retezce na cislo
+int numberParse(const char *data, int length, double *result)
+{
+	const char *position = data;
+	const char *end = data + length;
+	unsigned long long mantissa = 0;
+	int digitCount = 0;
+	int fractionDigits = 0;
+
+	// -------------- Preskoceni pocatecnich bilych znaku -----------------------
+	while (position < end && (*position == ' ' || *position == '\t' || *position == '\n'))
+		position++;
+
+	// -------------- Cela cast -------------------------------------------------
+	if (position == end || *position < '0' || *position > '9')
+		return 0;
+
+	while (position < end && *position >= '0' && *position <= '9')
+	{
+		mantissa = mantissa * 10 + (*position - '0');
+		digitCount++;
+		position++;
+	}
+
+	// -------------- Desetinna cast --------------------------------------------
+	if (position < end && *position == '.')
+	{
+		position++;
+		if (position == end || *position < '0' || *position > '9')
+			return 0;
+
+		while (position < end && *position >= '0' && *position <= '9')
+		{
+			mantissa = mantissa * 10 + (*position - '0');
+			digitCount++;
+			fractionDigits++;
+			position++;
+		}
+	}
+
+	// Exponent, dalsi znaky nebo prilis mnoho cislic resi obecny prevod
+	if (position != end || digitCount > PARSE_MAX_DIGITS)
+		return 0;
+
+	// Mantisa i mocnina deseti jsou presne, deleni zaokrouhli jen jednou
+	*result = (double) mantissa / exactPowersOfTen[fractionDigits];
+	return 1;
+}
@@ -0,0 +1,42 @@
+// number_conversion.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Conversions between numbers and their textual representation              *
+ ******************************************************************************
+ */
+
+#ifndef NUMBER_CONVERSION_H
+#define NUMBER_CONVERSION_H
+
+// Maximalni delka cisla ve formatu %g vcetne ukoncovaci nuly
+#define NUMBER_FORMAT_MAX_LENGTH 32
+
+/**
+ * Prevod cisla na retezec, vystup je totozny s formatem %g funkce printf.
+ * Cela cisla a cisla, ktera lze presne zaokrouhlit na 6 platnych cislic,
+ * se prevadi primo, ostatni pripady se prevedou pomoci snprintf
+ * @param  value  Prevadene cislo
+ * @param  buffer Buffer o velikosti alespon NUMBER_FORMAT_MAX_LENGTH, vysledek
+ *                je ukoncen nulou
+ * @return        Delka zapsaneho retezce bez ukoncovaci nuly
+ */
+int numberFormat(double value, char *buffer);
+
+/**
+ * Rychly prevod retezce na cislo pro nejcastejsi tvary - cela cisla
+ * a desetinna cisla s nejvyse 15 cislicemi (cifry[.cifry]), pred kterymi
+ * mohou byt mezery, tabulatory a konce radku. Vysledek je presne
+ * zaokrouhleny, stejne jako pri obecnem prevodu.
+ * Ostatni tvary funkce nezpracuje a prevod se musi provest obecnou funkci
+ * stringToDouble, ktera urcuje i chybove chovani
+ * @param  data   Prevadeny retezec
+ * @param  length Delka retezce
+ * @param  result Ukazatel pro ulozeni vysledku
+ * @return        1 pokud byl retezec preveden, 0 pokud jej nelze zpracovat
+ */
+int numberParse(const char *data, int length, double *result);
+
+#endif // NUMBER_CONVERSION_H
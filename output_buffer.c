@@ -0,0 +1,140 @@
+// output_buffer.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Output buffer used by builtin function print                               *
+ ******************************************************************************
+ */
+#include "output_buffer.h"
+#include "errnum.h"
+#include "number_conversion.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+	char *data;	// Pole pro ukladani vystupu
+	int size;	// Velikost bufferu
+	int used;	// Pocet obsazenych bajtu
+} tOutputBuffer;
+
+static tOutputBuffer outputBuffer = { NULL, 0, 0 };
+
+// Inicializace vystupniho bufferu
+ecode outputBufferInit(int size)
+{
+	if (size <= 0)
+		size = OUTPUT_BUFFER_SIZE;
+
+	// Do bufferu se musi vejit alespon jedno cislo
+	if (size < OUTPUT_NUMBER_MAX_LENGTH)
+		size = OUTPUT_NUMBER_MAX_LENGTH;
+
+	if (outputBuffer.data != NULL)
+		outputBufferFree();
+
+	outputBuffer.data = malloc(size);
+	if (outputBuffer.data == NULL)
+		return ERR_MEMORY;
+
+	outputBuffer.size = size;
+	outputBuffer.used = 0;
+	return ERR_OK;
+}
+
+// Zapis dat se znamou delkou
+ecode outputBufferWrite(const char *data, int length)
+{
+	ecode error;
+
+	if (outputBuffer.data == NULL)
+	{	// Buffer jeste nebyl inicializovan
+		error = outputBufferInit(0);
+		if (error != ERR_OK)
+			return error;
+	}
+
+	// Data se do zbytku bufferu nevejdou
+	if (length > outputBuffer.size - outputBuffer.used)
+	{
+		error = outputBufferFlush();
+		if (error != ERR_OK)
+			return error;
+
+		// Data vetsi nez cely buffer se zapisi primo
+		if (length >= outputBuffer.size)
+		{
+			if (fwrite(data, 1, length, stdout) != (size_t) length)
+				return ERR_RUNTIME_OTHER;
+			return ERR_OK;
+		}
+	}
+
+	memcpy(outputBuffer.data + outputBuffer.used, data, length);
+	outputBuffer.used += length;
+	return ERR_OK;
+}
+
+// Zapis cisla primo do bufferu
+ecode outputBufferWriteNumber(double value)
+{
+	ecode error;
+	int length;
+
+	if (outputBuffer.data == NULL)
+	{	// Buffer jeste nebyl inicializovan
+		error = outputBufferInit(0);
+		if (error != ERR_OK)
+			return error;
+	}
+
+	// Zajisteni mista pro nejdelsi mozne cislo
+	if (outputBuffer.size - outputBuffer.used < OUTPUT_NUMBER_MAX_LENGTH)
+	{
+		error = outputBufferFlush();
+		if (error != ERR_OK)
+			return error;
+	}
+
+	length = numberFormat(value, outputBuffer.data + outputBuffer.used);
+	if (length < 0 || length >= OUTPUT_NUMBER_MAX_LENGTH)
+		return ERR_INTERNAL;
+
+	outputBuffer.used += length;
+	return ERR_OK;
+}
+
+// Vyprazdneni bufferu na standardni vystup
+ecode outputBufferFlush()
+{
+	if (outputBuffer.used > 0)
+	{
+		if (fwrite(outputBuffer.data, 1, outputBuffer.used, stdout) != (size_t) outputBuffer.used)
+		{
+			outputBuffer.used = 0;
+			return ERR_RUNTIME_OTHER;
+		}
+		outputBuffer.used = 0;
+	}
+
+	if (fflush(stdout) != 0)
+		return ERR_RUNTIME_OTHER;
+
+	return ERR_OK;
+}
+
+// Vyprazdneni a uvolneni bufferu
+void outputBufferFree()
+{
+	if (outputBuffer.data == NULL)
+		return;
+
+	outputBufferFlush();
+	free(outputBuffer.data);
+	outputBuffer.data = NULL;
+	outputBuffer.size = 0;
+	outputBuffer.used = 0;
+}
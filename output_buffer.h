@@ -0,0 +1,61 @@
+// output_buffer.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Output buffer used by builtin function print                               *
+ ******************************************************************************
+ */
+
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include "errnum.h"
+
+// Vychozi velikost vystupniho bufferu, lze zmenit pri prekladu
+#ifndef OUTPUT_BUFFER_SIZE
+#define OUTPUT_BUFFER_SIZE 8192
+#endif
+
+#include "number_conversion.h"
+
+// Maximalni delka cisla vypsaneho ve formatu %g
+#define OUTPUT_NUMBER_MAX_LENGTH NUMBER_FORMAT_MAX_LENGTH
+
+/**
+ * Inicializace vystupniho bufferu
+ * @param  size Velikost bufferu v bajtech, pokud je <= 0 pouzije se
+ *              OUTPUT_BUFFER_SIZE
+ * @return      ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode outputBufferInit(int size);
+
+/**
+ * Zapis dat se znamou delkou do vystupniho bufferu, pokud se data do bufferu
+ * nevejdou, buffer se nejdrive vyprazdni
+ * @param  data   Zapisovana data
+ * @param  length Delka zapisovanych dat
+ * @return        ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode outputBufferWrite(const char *data, int length);
+
+/**
+ * Zapis cisla ve formatu %g primo do vystupniho bufferu
+ * @param  value Zapisovane cislo
+ * @return       ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode outputBufferWriteNumber(double value);
+
+/**
+ * Vyprazdneni bufferu na standardni vystup
+ * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode outputBufferFlush();
+
+/**
+ * Vyprazdneni a uvolneni vystupniho bufferu
+ */
+void outputBufferFree();
+
+#endif // OUTPUT_BUFFER_H
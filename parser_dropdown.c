@@ -16,6 +16,13 @@
 #include "ilist.h"	// Seznam instrukci
 #include "global.h"	// Globalni promenne
 #include "variable.h"	// Promenna
+#include "string_ops.h"	// Tabulky pro hledani konstantnich podretezcu
+#include "constant_pool.h"	// Tabulka konstant
+#include "compile_arena.h"	// Arena prekladu
+#include "label_stack.h"	// Zasobnik navesti
+#include "symbol_index.h"	// Rozptylovaci index tabulek symbolu
+#include "source_scan.h"	// Nacteny zdroj a pre-scanner hlavicek funkci
+#include "program_cache.h"	// Cache prelozeneho programu
 #include "string.h"
 
 // Makra pro urceni typu tokenu
@@ -43,35 +50,87 @@
 #define isNumeric(x) ((x) == TT_NUMBER)
 #define STACK_CALL_SPACE 2
 
-typedef enum { FUNCTION_PRINT, FUNCTION_TYPEOF, FUNCTION_OTHER} ParsedFunction;
+// Navesti konce funkce (cil prikazu return), v kazde funkci prvni navesti
+#define RETURN_LABEL 0
+
+// Kontext prekladu jednoho tela (hlavniho tela nebo funkce). Kazde telo ma
+// vlastni seznam instrukci, navesti a pocitadlo pomocnych promennych, parser
+// je predava parametrem misto sdilenych globalnich promennych
+typedef struct
+{
+	tFunctionData *function;	// Zaznam prekladane funkce ($main pro hlavni telo)
+	tIList *instructions;		// Seznam, do ktereho se generuji instrukce
+	tLabelTable labels;			// Tabulka navesti tela
+	tLabelStack *labelStack;	// Navesti vnorenych if a while bez instrukce
+	int savedVariableCount;		// internalVariableCount nadrazeneho tela
+} tCompileContext;
+
+// Zdrojovy kod nacteny pro prvni pruchod
+tSource programSource;
+
+#ifdef PARSER_LAZY_FUNCTIONS
+#include <stdint.h>
+
+// Definice funkce ve zdroji, ktera se prelozi az pri prvnim volani
+typedef struct
+{
+	tFunctionData *function;	// Zaznam funkce (NULL = volno)
+	size_t begin;				// Pozice definice ve zdroji
+	size_t end;					// Pozice za koncem definice
+	int line;					// Radek zacatku definice
+	int endLine;				// Radek za koncem definice
+} tLazyFunction;
+
+// Rozptylovaci tabulka odlozenych funkci podle zaznamu funkce
+struct
+{
+	tLazyFunction *items;
+	int count;
+	int size;					// Velikost tabulky (mocnina dvou)
+} lazyFunctions = { NULL, 0, 0 };
+
+#define LAZY_FUNCTIONS_INIT 64
+
+ecode lazyFunctionInsert(tFunctionData *function, tFunctionHeader *header);
+tLazyFunction *lazyFunctionFind(tFunctionData *function);
+ecode skipFuncDef(FILE *file);
+#endif
 
 ecode determineError(TokenType token);
-ecode parseFirstPass(FILE *file);
-ecode parseFuncDef(FILE *file);
-ecode parseParams(FILE *file, tFunctionData *functionRecord);
-ecode parseParamsNext(FILE *file, tFunctionData *functionRecord);
-ecode parseParamsFirstPass(FILE *file, int *paramsCount);
-ecode parseStatementList(FILE *file, tFunctionData *functionRecord);
-ecode parseStatement(FILE *file, tFunctionData *functionRecord);
+void releaseParseState(void *unused);
+ecode parseFirstPass(tSource *source);
+ecode parseFuncDef(FILE *file, tIList *functions);
+ecode parseParams(FILE *file, tCompileContext *context);
+ecode parseParamsNext(FILE *file, tCompileContext *context);
+ecode parseStatementList(FILE *file, tCompileContext *context);
+ecode parseStatement(FILE *file, tCompileContext *context);
 ecode parseFile(FILE *file);
+static ecode parseSource(FILE *file, const char *cachePath, uint64_t key);
 ecode parseProgram(FILE *file);
-ecode parseIf(FILE *file, tFunctionData *functionRecord);
-ecode parseWhile(FILE *file, tFunctionData *functionRecord);
-ecode parseReturn(FILE *file, tFunctionData *functionRecord);
-ecode parseAssignment(FILE *file, tFunctionData *functionRecord);
-ecode parseRightHandSide(FILE *file, tFunctionData *functionRecord, int **offset, int *numberOfTemporaryItems);
-ecode parseFunctionCall(FILE *file, tFunctionData *functionRecord, int **offset, int *numberOfTemporaryItems);
-ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, int *numberOfTemporaryItems);
-ecode parseFunctionCallParams(FILE *file, tFunctionData *functionRecord, ParsedFunction function, int paramsToPush);
-ecode parseParamsTerm(FILE *file, tFunctionData *functionRecord, ParsedFunction function, int paramsToPush, int *pushedParams);
+static ecode parseProgramBody(FILE *file, tCompileContext *context);
+static ecode parseFuncDefBody(FILE *file, tCompileContext *context);
+static ecode compileContextInit(tCompileContext *context, tFunctionData *function, tIList *instructions);
+static void compileContextFree(tCompileContext *context);
+ecode parseIf(FILE *file, tCompileContext *context);
+ecode parseWhile(FILE *file, tCompileContext *context);
+ecode parseReturn(FILE *file, tCompileContext *context);
+ecode parseAssignment(FILE *file, tCompileContext *context);
+ecode parseRightHandSide(FILE *file, tCompileContext *context, int **offset, int *numberOfTemporaryItems);
+ecode parseFunctionCall(FILE *file, tCompileContext *context, int **offset, int *numberOfTemporaryItems);
+ecode parseSubstring(FILE *file, tCompileContext *context, int **offset, int *numberOfTemporaryItems);
+ecode parseFunctionCallParams(FILE *file, tCompileContext *context, ParsedFunction function, int paramsToPush, tOperandList **params);
+ecode parseParamsTerm(FILE *file, tCompileContext *context, ParsedFunction function, void **operand);
+ecode generateBuiltinCall(tCompileContext *context, ParsedFunction function, tOperandList *params, int **offset);
 
 ecode generateMainFunctionRecord();
 ecode generateAndInsertInstruction(tIList *list, InstructionType type, void *target, void *op1, void *op2);
 ecode generateAndInsertTemporaryVariable(tIList *instrList, tTableHead *symTable, SemanticType type, void *data, int **offset);
+ecode generateTemporaryOffset(tTableHead *symTable, int **offset);
 SemanticType tokenTypeToSemanticType(TokenType type);
 
-String *generateLabelName();
-String *generateVariableName();
+ecode generateLabel(tCompileContext *context, int *label);
+void resolveLabel(tCompileContext *context);
+ecode generateJump(tCompileContext *context, InstructionType type, int label, void *condition);
 ecode insertParamToSymbolTable(tTableHead* symbolTable, String* name);
 
 ecode determineError(TokenType token)
@@ -99,122 +158,242 @@ ecode parseFile(FILE *file)
 {
 	ecode error;
 
+	// Zdroj se nacte najednou, prvni pruchod ho prochazi primo v pameti
+	error = sourceLoad(file, &programSource);
+	if (error)
+	{
+		sourceFree(&programSource);
+		return error;
+	}
+
+	return parseSource(file, NULL, 0);
+}
+
+// Preklad s cache prelozeneho programu
+ecode parseFileCached(FILE *file, const char *cachePath)
+{
+	ecode error;
+	uint64_t key = 0;
+
+	error = sourceLoad(file, &programSource);
+	if (error)
+	{
+		sourceFree(&programSource);
+		return error;
+	}
+
+#ifndef PARSER_LAZY_FUNCTIONS
+	// Odlozeny preklad funkci cache nepouziva, program neni prelozen cely
+	bool loaded;
+	key = programCacheKey(programSource.data, programSource.length);
+	error = programCacheLoad(cachePath, key, &loaded);
+	if (error || loaded)
+	{
+		sourceFree(&programSource);
+		return error;
+	}
+#endif
+
+	return parseSource(file, cachePath, key);
+}
+
+/**
+ * Kontrola, ze predchozi program byl uvolnen. Program se preklada do
+ * globalnich struktur, novy preklad by se pripojil k predchozimu
+ * @return ERR_OK pokud je vse uvolneno, jinak ERR_INTERNAL
+ */
+static ecode checkProgramReleased()
+{
+	tTableItem *item;
+	String *name;
+
+	// Seznam instrukci a tabulku konstant uvolni tIListFree
+	if (instructionList->first != NULL || constantPool.count != 0)
+		return ERR_INTERNAL;
+
+	// Tabulku funkci uvolnuje volajici, zaznam $main ma kazdy prelozeny program
+	name = charToString(MAIN_FUNCTION_NAME);
+	if (name == NULL)
+		return ERR_MEMORY;
+	item = searchItem(functionTable, name);
+	deallocString(name);
+
+	return item == NULL ? ERR_OK : ERR_INTERNAL;
+}
+
+// Preklad programu z pameti
+ecode parseBuffer(const char *src, size_t length)
+{
+	ecode error;
+
+	error = checkProgramReleased();
+	if (error)
+		return error;
+
+	// Prvni pruchod cte primo buffer, scanner ho cte pres fmemopen
+	sourceFromBuffer(src, length, &programSource);
+
+	return parseSource(NULL, NULL, 0);
+}
+
+/**
+ * Preklad nacteneho zdroje programSource, oba pruchody
+ * @param  file      Puvodni zdrojovy soubor (NULL u zdroje z bufferu)
+ * @param  cachePath Soubor cache pro zapis prelozeneho programu nebo NULL
+ * @param  key       Klic zdrojoveho kodu pro cache
+ * @return           ERR_OK pokud je vse v poradku, jinak prislusny kod
+ */
+static ecode parseSource(FILE *file, const char *cachePath, uint64_t key)
+{
+	ecode error;
+	FILE *scannerFile;
+
+	// Index tabulek symbolu pro hledani jmen bez pruchodu stromem
+	error = symbolIndexInit();
+	if (error)
+	{
+		sourceFree(&programSource);
+		return error;
+	}
+
 	// Prvni pruchod
 	// Slouzi pouze k pridani identifikatoru funkci do tabulky funkci
-	error = parseFirstPass(file);
+	error = parseFirstPass(&programSource);
 	if (error)
+	{
+		releaseParseState(NULL);
 		return error;
+	}
 
-	// Pretoceni souboru na zacatek
-	rewind(file);
+	// Scanner cte zdroj jen ve druhem pruchodu
+	scannerFile = sourceOpen(file, &programSource);
+	if (scannerFile == NULL)
+	{
+		releaseParseState(NULL);
+		return ERR_INTERNAL;
+	}
 	_lineNumber = 1;
 
 	// Druhy pruchod, tentokrat uz se bude zpracovavat kazde pravidlo a pomoci
 	// semantickych akci se budou generovat prislusne instrukce 3AK
-	error = parseProgram(file);
+	error = parseProgram(scannerFile);
 
+	if (scannerFile != file)
+		fclose(scannerFile);
+
+#ifdef PARSER_LAZY_FUNCTIONS
+	// Odlozene funkce se prekladaji za behu, stav prekladu se uvolni
+	// spolu s arenou prekladu (tIListFree)
+	if (error == ERR_OK)
+	{
+		error = compileArenaRegister(&programSource, releaseParseState);
+		if (error == ERR_OK)
+			return ERR_OK;
+	}
+#else
+	// Cache se zapisuje dokud je platny index tabulek symbolu, chyba zapisu
+	// neni chybou prekladu
+	if (error == ERR_OK && cachePath != NULL)
+		programCacheSave(cachePath, key);
+#endif
+
+	releaseParseState(NULL);
 	return error;
 }
 
 
+/**
+ * Uvolneni stavu prekladu - zdroje a indexu tabulek symbolu
+ * @param unused Nepouzito (funkce pro uvolneni prostredku areny prekladu)
+ */
+void releaseParseState(void *unused)
+{
+	symbolIndexFree();
+	sourceFree(&programSource);
+
+#ifdef PARSER_LAZY_FUNCTIONS
+	free(lazyFunctions.items);
+	lazyFunctions.items = NULL;
+	lazyFunctions.count = lazyFunctions.size = 0;
+#endif
+}
+
+
 /**
  * Funkce pro prvni pruchod syntakticke analyzy, spocivajici pouze v tom,
  * ze hleda definice funkci, pro ktere vytvari zaznamy v tabulce funkci
- * a pocita jejich parametry, pro pozdejsi vyuziti.
- * @param  file Zdrojovy kod
- * @return      ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ * a pocita jejich parametry, pro pozdejsi vyuziti. Zdroj neprochazi scanner,
+ * ale pre-scanner nad nactenym zdrojem, ktery zna jen hlavicky funkci.
+ * @param  source Nacteny zdrojovy kod
+ * @return        ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseFirstPass(FILE *file)
+ecode parseFirstPass(tSource *source)
 {
 	ecode error;
-	Token currentToken;
-	tTableItem *functionRecord;
+	tSourceScan scan;
+	tFunctionHeader header;
+	bool found;
+	String key;
+	String *name;
+	char *buffer;
 	tFunctionData *data;
-	int paramsCount = 0;
 
-	currentToken = getToken(file);
-	// --------------- Token nepredstavuje funkci, prikaz ani konec souboru-----------
-	if (!isStatement(currentToken.type) && !isFuncDef(currentToken.type) && !isEOF(currentToken.type))
-	{   // -------------- Pro token neni pravidlo ------------------------------------
-		deallocToken(currentToken);
-		return determineError(currentToken.type);
-	}
+	sourceScanInit(&scan, source);
 
-	// ------------------ Pruchod celym souborem -------------------------------------
-	while (!isEOF(currentToken.type))
+	// ------------------ Pruchod hlavickami funkci ----------------------------------
+	while ((error = sourceNextFunction(&scan, &header, &found)) == ERR_OK && found)
 	{
-		// --------------- Token function --------------------------------------------
-		if (isFuncDef(currentToken.type))
-		{
-			// Vytvoreni zaznamu o funkci
-			data = malloc(sizeof(tFunctionData));
-			if (data == NULL)
-				return ERR_MEMORY;
-			data->firstInstruction = NULL;
-			data->paramsCount = 0;
-			data->varTabHead = NULL;
-
-			// --------------- Token identifikator ------------------------------------
-			currentToken = getToken(file);
-			if (!isIdentifier(currentToken.type))
-			{   // -------------- Pro token neni pravidlo ------------------------------
-				deallocToken(currentToken);
-				free(data);
-				return determineError(currentToken.type);
-			}
-
-			// -------------- Kontrola predchozi definice funkce -----------------------
-			functionRecord = searchItem(functionTable, currentToken.item);
-			if (functionRecord != NULL)
-			{
-				// ---------- Funkce jiz byla definovana -------------------------------
-				deallocToken(currentToken);
-				free(data);
-				return ERR_SEMANTICS_OTHER;
-			}
-
-			// -------------- Vlozeni jmena funkce do tabulky funkci -------------------
-			error = insertItem(functionTable, currentToken.item, ITEM_FUNCTION, data);
-			if (error)
-			{   // ---------- Nepodarilo se pridat funkci ------------------------------
-				deallocToken(currentToken);
-				free(data);
-				return error;
-			}
-
-			// -------------- Token leva zavorka --------------------------------------
-			currentToken = getToken(file);
-			if (!isLeftBracket(currentToken.type))
-			{   // -------------- Pro token neni pravidlo ------------------------------
-				deallocToken(currentToken);
-				return determineError(currentToken.type);
-			}
-
-			// -------------- Analyza paramteru funkce - prvni pruchod -----------------
-			error = parseParamsFirstPass(file, &paramsCount);
-			if (error)
-				return error;
-
-			// -------------- Token prava zavorka --------------------------------------
-			currentToken = getToken(file);
-			if (!isRightBracket(currentToken.type))
-			{   // -------------- Pro token neni pravidlo ------------------------------
-				deallocToken(currentToken);
-				return determineError(currentToken.type);
-			}
+		// -------------- Kontrola predchozi definice funkce -----------------------
+		key.data = (char *) header.name;
+		key.length = header.length;
+		if (symbolIndexSearch(functionTable, &key) != NULL)
+			return ERR_SEMANTICS_OTHER;    // Funkce jiz byla definovana
+
+		// Vytvoreni zaznamu o funkci
+		data = malloc(sizeof(tFunctionData));
+		if (data == NULL)
+			return ERR_MEMORY;
+		data->firstInstruction = NULL;
+		data->paramsCount = header.paramsCount;
+		data->varTabHead = NULL;
 
-			// -------------- Do zaznamu funkce vlozi pocet parametru --------------------
-			data->paramsCount = paramsCount;
-			paramsCount = 0;    // Nulovani pocitadla parametru
+		// -------------- Jmeno funkce ze zdroje, vlastni ho tabulka funkci ---------
+		buffer = malloc(header.length + 1);
+		if (buffer == NULL)
+		{
+			free(data);
+			return ERR_MEMORY;
 		}
-		else
-		{   // -------------- Nejedna se o definici funkce -------------------------------
-			deallocToken(currentToken);
-			currentToken = getToken(file);
+		memcpy(buffer, header.name, header.length);
+		buffer[header.length] = '\0';
+		name = charToString(buffer);
+		free(buffer);
+		if (name == NULL)
+		{
+			free(data);
+			return ERR_MEMORY;
+		}
+
+		// -------------- Vlozeni jmena funkce do tabulky funkci -------------------
+		error = symbolIndexInsert(functionTable, name, ITEM_FUNCTION, data);
+		if (error)
+		{   // ---------- Nepodarilo se pridat funkci ------------------------------
+			deallocString(name);
+			free(data);
+			return error;
 		}
+
+#ifdef PARSER_LAZY_FUNCTIONS
+		// -------------- Zapamatovani definice pro preklad pri prvnim volani -------
+		error = sourceFunctionRange(&scan, &header);
+		if (error == ERR_OK)
+			error = lazyFunctionInsert(data, &header);
+		if (error)
+			return error;
+#endif
 	}
 
-	return ERR_OK;
+	return error;
 }
 
 
@@ -227,14 +406,11 @@ ecode parseFirstPass(FILE *file)
  */
 ecode parseProgram(FILE *file)
 {
-	Token currentToken;
 	ecode error;
+	tCompileContext context;
 
 	tFunctionData *functionRecord;  // Zaznam funkce
-	tTableItem *varItem;                // Polozka tabulky symbolu
 	String *name;                   // Jmeno noveho zaznamu
-	String *labelName;              // Jmeno navesti
-	tIListItem **label = NULL;      // Ukazatel na navesti
 
 	// -------------- Vytvoreni zaznamu pro hlavni pseudofunkci ------------------
 	error = generateMainFunctionRecord();
@@ -243,62 +419,65 @@ ecode parseProgram(FILE *file)
 
 	// -------------- Vyhledani zaznamu hlavni funkce ----------------------------
 	name = charToString(MAIN_FUNCTION_NAME);
-	functionRecord = searchItem(functionTable, name)->data;
+	functionRecord = symbolIndexSearch(functionTable, name)->data;
 	deallocString(name);
 
+	// -------------- Hlavni telo se preklada ve vlastnim kontextu ---------------
+	error = compileContextInit(&context, functionRecord, instructionList);
+	if (error)
+		return error;
+
+	error = parseProgramBody(file, &context);
+	compileContextFree(&context);
+	return error;
+}
+
+/**
+ * Preklad hlavniho tela programu a definic funkci v kontextu hlavniho tela.
+ * Tela funkci se prekladaji do vlastnich seznamu a pripoji se za HALT
+ * @param  file    Zdrojovy soubor
+ * @param  context Kontext prekladu hlavniho tela
+ * @return         ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode parseProgramBody(FILE *file, tCompileContext *context)
+{
+	Token currentToken;
+	ecode error;
+	int label;                      // Navesti konce hlavniho tela
+	tIList functions;               // Prelozena tela funkci
+
+	tIListInit(&functions);
+
+	// -------------- Navesti konce hlavniho tela --------------------------------
+	error = tLabelTableNew(&context->labels, &label);
+	if (error)
+		return error;
+
 	currentToken = getToken(file);
 	while(!isEOF(currentToken.type))
 	{
 		// -------------- Token function ---------------------------------------------
 		if (isFuncDef(currentToken.type))
 		{
-			// -------------- Generovani navesti funkce ----------------------------------
-			labelName = generateLabelName();
-			if (labelName == NULL)  // Nedostatek pameti
-				return ERR_MEMORY;
-
-			// -------------- Navesti se prida do lokalni tabulky symbolu ----------------
-			error = insertItem(functionRecord->varTabHead, labelName, ITEM_LABEL, NULL);
-			if (error)
-			{
-				deallocString(labelName);
-				return error;
-			}
-			// -------------- Vyhledani navesti v TS -------------------------------------
-			varItem = searchItem(functionRecord->varTabHead, labelName);
-			// -------------- Ziska se ukazatel na ukazatel ulozeny v TS -----------------
-			label = (tIListItem **) &(varItem->data);
-
-			// -------------- Generovani intrukce pro skok za definici funkce ------------
-			error = generateAndInsertInstruction(instructionList, INSTR_GOTO, label, NULL, NULL);
-			if (error)
-			{
-				return error;
-			}
-
-			// -------------- Analyza definice funkce ------------------------------------
+#ifdef PARSER_LAZY_FUNCTIONS
+			// -------------- Definice se prelozi pri prvnim volani funkce ---------------
+			deallocToken(currentToken);
+			error = skipFuncDef(file);
+#else
+			// -------------- Analyza definice funkce do segmentu funkci ----------------
+			// -------------- (hlavni telo ji neprochazi, skok za ni neni potreba) ------
 			returnToken(currentToken);
-			error = parseFuncDef(file);
+			error = parseFuncDef(file, &functions);
+#endif
 			if (error)
 				return error;
-
-
-			// -------------- Vygeneruje se instrukce navesti pro obskoceni --------------
-			error = generateAndInsertInstruction(instructionList, INSTR_LABEL, NULL, NULL, NULL);
-			if (error)
-			{
-				return error;
-			}
-			// -------------- Do TS se k navesti priradi adresa instrukce ----------------
-			*label = tIListGetLast(instructionList);
-
 		}
 		// -------------- Token patrici do statement ---------------------------------
 		else if (isStatement(currentToken.type))
 		{
 			// -------------- Analyza prikazu --------------------------------------------
 			returnToken(currentToken);
-			error = parseStatement(file, functionRecord);
+			error = parseStatement(file, context);
 			if (error)
 				return error;
 		}
@@ -313,13 +492,20 @@ ecode parseProgram(FILE *file)
 
 	// -------------- Token je EOF - konec analyzy zdrojoveho kodu ---------------
 	// -------------- Generovani instrukce pro konec kodu ------------------------
-	error = generateAndInsertInstruction(instructionList, INSTR_HALT, NULL, NULL, NULL);
+	error = generateAndInsertInstruction(context->instructions, INSTR_HALT, NULL, NULL, NULL);
 	if (error)
 		return error;
 
-	functionRecord->lastInstruction = tIListGetLast(instructionList);
+	context->function->lastInstruction = tIListGetLast(context->instructions);
 
-	return ERR_OK;
+	// -------------- Doplneni skoku hlavniho tela -------------------------------
+	tLabelTableSet(&context->labels, RETURN_LABEL, context->function->lastInstruction);
+	error = tLabelTableResolve(&context->labels);
+	if (error)
+		return error;
+
+	// -------------- Tela funkci se pripoji za konec hlavniho tela --------------
+	return tIListAppendList(context->instructions, &functions);
 }
 
 // Syntakticka analyza pro neterminal <func_def>
@@ -332,22 +518,20 @@ ecode parseProgram(FILE *file)
  * 		function id (<params>) EOL
  * 			<statement_list>
  *    	end EOL
- * @param  file Zdrojovy soubor
- * @return      ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ * Telo funkce se preklada ve vlastnim kontextu do samostatneho seznamu
+ * instrukci, ktery se po uspesnem prekladu pripoji na konec seznamu functions
+ * @param  file      Zdrojovy soubor
+ * @param  functions Seznam, na jehoz konec se pripoji prelozene telo funkce
+ * @return           ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseFuncDef(FILE *file)
+ecode parseFuncDef(FILE *file, tIList *functions)
 {
 	Token currentToken;
 	ecode error;
-	int mainVarCount;
 	tFunctionData *functionRecord;
 	tTableItem *functionItem;
-	String *labelName, *returnName;
-
-	// -------------- Ulozeni poctu pomocnych promennych v hlavnim tele --------
-	// -------------- Vynulovani poctu pomocnych promennych pro funkci ---------
-	mainVarCount = internalVariableCount;
-	internalVariableCount = 0;
+	tCompileContext context;
+	tIList segment;
 
 	// -------------- Token function -------------------------------------------
 	currentToken = getToken(file);
@@ -367,7 +551,7 @@ ecode parseFuncDef(FILE *file)
 
 	// -------------- Nastaveni zaznamu funkce v tabulce funkci ------------------
 
-	functionItem = searchItem(functionTable, currentToken.item);
+	functionItem = symbolIndexSearch(functionTable, currentToken.item);
 	// Zaznam jiz je v tabulce od prvniho pruchodu
 	functionRecord = functionItem->data;
 	deallocToken(currentToken); // Uvolneni pameti retezce s identifikatorem
@@ -383,17 +567,56 @@ ecode parseFuncDef(FILE *file)
 	// Inicializace poctu prvku na -pocet parametru, aby se zapocitaly pouze vnitrni promenne
 	functionRecord->varTabHead->itemCount = -functionRecord->paramsCount - 1;
 
+	// -------------- Funkce ma vlastni kontext a seznam instrukci --------------
+	tIListInit(&segment);
+	error = compileContextInit(&context, functionRecord, &segment);
+	if (error)
+		return error;
+
+	// -------------- Ulozeni poctu pomocnych promennych nadrazeneho tela ------
+	// -------------- Vynulovani poctu pomocnych promennych pro funkci ---------
+	context.savedVariableCount = internalVariableCount;
+	internalVariableCount = 0;
 
+	error = parseFuncDefBody(file, &context);
+
+	// -------------- Nastavi pocitadlo promennych zpet pro nadrazene telo -----
+	internalVariableCount = context.savedVariableCount;
+	compileContextFree(&context);
+	if (error)
+		return error;
+
+	// -------------- Prelozene telo se pripoji za ostatni funkce --------------
+	return tIListAppendList(functions, &segment);
+}
+
+/**
+ * Preklad zbytku definice funkce od parametru po end EOL v kontextu funkce
+ * @param  file    Zdrojovy soubor
+ * @param  context Kontext prekladu funkce
+ * @return         ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode parseFuncDefBody(FILE *file, tCompileContext *context)
+{
+	Token currentToken;
+	ecode error;
+	tFunctionData *functionRecord = context->function;
+	String *returnName;
+	int label;
+
+	error = tLabelTableNew(&context->labels, &label);
+	if (error)
+		return error;
 
 	// -------------- Vygeneruje instrukci navesti uvozujici funkci --------------
-	error = generateAndInsertInstruction(instructionList, INSTR_LABEL, NULL, NULL, NULL);
+	error = generateAndInsertInstruction(context->instructions, INSTR_LABEL, NULL, NULL, NULL);
 	if (error)
 	{
 		return error;
 	}
 
 	// -------------- Vlozi instrukci do zaznamu funkce --------------------------
-	functionRecord->firstInstruction = tIListGetLast(instructionList);
+	functionRecord->firstInstruction = tIListGetLast(context->instructions);
 
 	// -------------- Token leva zavorka -----------------------------------------
 	currentToken = getToken(file);
@@ -404,7 +627,7 @@ ecode parseFuncDef(FILE *file)
 	}
 
 	// -------------- Analyza parametru funkce -----------------------------------
-	error = parseParams(file, functionRecord);
+	error = parseParams(file, context);
 	if (error)
 		return error;
 
@@ -442,35 +665,24 @@ ecode parseFuncDef(FILE *file)
 
 	// -------------- Analyza sekvence prikazu -----------------------------------
 	returnToken(currentToken);
-	error = parseStatementList(file, functionRecord);
+	error = parseStatementList(file, context);
 	if (error)
 		return error;
 
-	// -------------- Vygeneruje se navesti pro skok na konec funkce -------------
-	labelName = generateLabelName();
-	if (labelName == NULL)
-		return ERR_MEMORY;
+	// -------------- Nastavi navesti konce jako posledni instrukci funkce -------
+	functionRecord->lastInstruction = tIListGetLast(context->instructions);
+	tLabelTableSet(&context->labels, RETURN_LABEL, functionRecord->lastInstruction);
 
-	// -------------- Ulozi navesti do TS ----------------------------------------
-	error = insertItem(functionRecord->varTabHead, labelName, ITEM_LABEL, NULL);
+	// -------------- Vygeneruje instrukci navratu z volani funkce ---------------
+	error = generateAndInsertInstruction(context->instructions, INSTR_RET, &(functionRecord->paramsCount), NULL, NULL);
 	if (error)
-	{
-		deallocString(labelName);
 		return error;
-	}
-
-	// -------------- Nastavi navesti jako posledni instrukci funkce -------------
-	functionRecord->lastInstruction = tIListGetLast(instructionList);
-
 
-	// -------------- Vygeneruje instrukci navratu z volani funkce ---------------
-	error = generateAndInsertInstruction(instructionList, INSTR_RET, &(functionRecord->paramsCount), NULL, NULL);
+	// -------------- Doplneni skoku funkce ------------------------------------
+	error = tLabelTableResolve(&context->labels);
 	if (error)
 		return error;
 
-	// -------------- Nastavi pocitadlo promennych zpet pro hlavni telo --------
-	internalVariableCount = mainVarCount;
-
 	// -------------- Token end --------------------------------------------------
 	currentToken = getToken(file);
 	if (!isEnd(currentToken.type))
@@ -491,18 +703,154 @@ ecode parseFuncDef(FILE *file)
 }
 
 
+#ifdef PARSER_LAZY_FUNCTIONS
+/**
+ * Pozice odlozene funkce v rozptylovaci tabulce, pri neuspechu volna pozice
+ */
+static tLazyFunction *lazyFunctionSlot(tFunctionData *function)
+{
+	unsigned int slot = (unsigned int) ((uintptr_t) function >> 4) * 2654435761u & (lazyFunctions.size - 1);
+
+	while (lazyFunctions.items[slot].function != NULL && lazyFunctions.items[slot].function != function)
+		slot = (slot + 1) & (lazyFunctions.size - 1);
+
+	return &lazyFunctions.items[slot];
+}
+
+/**
+ * Zapamatovani definice funkce, ktera se prelozi pri prvnim volani
+ * @param  function Zaznam funkce
+ * @param  header   Hlavicka a rozsah definice ze zdroje
+ * @return          ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+ecode lazyFunctionInsert(tFunctionData *function, tFunctionHeader *header)
+{
+	tLazyFunction *oldItems = lazyFunctions.items;
+	int oldSize = lazyFunctions.size;
+	tLazyFunction *item;
+
+	// -------------- Zaplneni nejvyse do poloviny -------------------------------
+	if (2 * (lazyFunctions.count + 1) > lazyFunctions.size)
+	{
+		lazyFunctions.size = oldSize == 0 ? LAZY_FUNCTIONS_INIT : oldSize * 2;
+		lazyFunctions.items = calloc(lazyFunctions.size, sizeof(tLazyFunction));
+		if (lazyFunctions.items == NULL)
+		{
+			lazyFunctions.items = oldItems;
+			lazyFunctions.size = oldSize;
+			return ERR_MEMORY;
+		}
+
+		for (int i = 0; i < oldSize; i++)
+		{
+			if (oldItems[i].function != NULL)
+				*lazyFunctionSlot(oldItems[i].function) = oldItems[i];
+		}
+		free(oldItems);
+	}
+
+	item = lazyFunctionSlot(function);
+	item->function = function;
+	item->begin = header->begin;
+	item->end = header->end;
+	item->line = header->line;
+	item->endLine = header->endLine;
+	lazyFunctions.count++;
+	return ERR_OK;
+}
+
+/**
+ * Vyhledani odlozene funkce podle zaznamu funkce
+ * @param  function Zaznam funkce
+ * @return          Odlozena funkce nebo NULL
+ */
+tLazyFunction *lazyFunctionFind(tFunctionData *function)
+{
+	tLazyFunction *item;
+
+	if (lazyFunctions.size == 0)
+		return NULL;
+
+	item = lazyFunctionSlot(function);
+	return item->function != NULL ? item : NULL;
+}
+
+/**
+ * Preskoceni definice funkce ve druhem pruchodu. Token function uz je
+ * precteny, podle jmena funkce se scanner presune za konec definice
+ * nalezeny prvnim pruchodem. Predpoklada se, ze scanner nema nactene
+ * znaky mimo soubor (vraceny znak ungetc fseek zahodi)
+ * @param  file Zdrojovy soubor
+ * @return      ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode skipFuncDef(FILE *file)
+{
+	Token currentToken;
+	tTableItem *functionItem;
+	tLazyFunction *lazy;
+
+	// -------------- Token identifikator ----------------------------------------
+	currentToken = getToken(file);
+	if (!isIdentifier(currentToken.type))
+	{   // -------------- Pro token neni pravidlo ------------------------------
+		deallocToken(currentToken);
+		return determineError(currentToken.type);
+	}
+
+	functionItem = symbolIndexSearch(functionTable, currentToken.item);
+	deallocToken(currentToken);
+	lazy = functionItem != NULL ? lazyFunctionFind(functionItem->data) : NULL;
+	if (lazy == NULL)
+		return ERR_INTERNAL;
+
+	// -------------- Pokracovani za koncem definice -----------------------------
+	if (fseek(file, lazy->end, SEEK_SET) != 0)
+		return ERR_INTERNAL;
+	_lineNumber = lazy->endLine;
+
+	return ERR_OK;
+}
+
+// Preklad odlozene funkce pri prvnim volani
+ecode parseFunction(tFunctionData *functionRecord)
+{
+	ecode error;
+	tLazyFunction *lazy;
+	int lineNumber = _lineNumber;
+	FILE *file;
+
+	lazy = lazyFunctionFind(functionRecord);
+	if (lazy == NULL)
+		return ERR_INTERNAL;
+
+	// -------------- Scanner cte jen definici funkce ze zdroje ------------------
+	file = fmemopen(programSource.data + lazy->begin, lazy->end - lazy->begin, "r");
+	if (file == NULL)
+		return ERR_INTERNAL;
+	_lineNumber = lazy->line;
+
+	// -------------- Telo funkce se pripoji na konec programu -------------------
+	error = parseFuncDef(file, instructionList);
+
+	fclose(file);
+	_lineNumber = lineNumber;
+	return error;
+}
+#endif
+
+
 /**
  * Syntakticka analyza pro seznam parametru v definici funkce.
  * Zpracovava neterminal <params>, pokud ma funkce vice jak jeden parametr,
- * zavola funkci parseParamsNext(FILE *file, tFunctionData *functionRecord)
+ * zavola funkci parseParamsNext(FILE *file, tCompileContext *context)
  * pro jejich zpracovani
  * Pridava polozky identifikatoru parametru do TS definovane funkce
  *
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context        Kontext prekladu zpracovavane funkce
  * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseParams(FILE *file, tFunctionData *functionRecord)
+ecode parseParams(FILE *file, tCompileContext *context)
 {
 	Token currentToken;
 	ecode error;
@@ -518,7 +866,7 @@ ecode parseParams(FILE *file, tFunctionData *functionRecord)
 	else if (isIdentifier(currentToken.type))
 	{
 		// -------------- Vlozi identifikator parametru do TS ------------------
-		error = insertParamToSymbolTable(functionRecord->varTabHead, currentToken.item);
+		error = insertParamToSymbolTable(context->function->varTabHead, currentToken.item);
 		if (error)
 		{
 			deallocToken(currentToken);
@@ -543,7 +891,7 @@ ecode parseParams(FILE *file, tFunctionData *functionRecord)
 	else	// Token neni prava zavorka, parametry pokracuji
 	{
 		returnToken(currentToken);
-		error = parseParamsNext(file, functionRecord);
+		error = parseParamsNext(file, context);
 	}
 
 
@@ -555,10 +903,10 @@ ecode parseParams(FILE *file, tFunctionData *functionRecord)
  * Pridava polozky identifikatoru parametru do TS definovane funkce
  * Zpracovava neterminal <params_n>
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context        Kontext prekladu zpracovavane funkce
  * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseParamsNext(FILE *file, tFunctionData *functionRecord)
+ecode parseParamsNext(FILE *file, tCompileContext *context)
 {
 	ecode error;
 	Token currentToken;
@@ -582,7 +930,7 @@ ecode parseParamsNext(FILE *file, tFunctionData *functionRecord)
 		}
 
 		// -------------- Pridani identifikatoru do TS ---------------------------
-		error = insertParamToSymbolTable(functionRecord->varTabHead, currentToken.item);
+		error = insertParamToSymbolTable(context->function->varTabHead, currentToken.item);
 		if (error)
 		{
 			deallocToken(currentToken);
@@ -605,12 +953,12 @@ ecode parseParamsNext(FILE *file, tFunctionData *functionRecord)
  * nebo while.
  * V pripade tokenu pro ktere jsou epsilon pravidla dojde k dokonceni zpracovani
  * sekvence prikazu, jinak zavola funkci pro zpracovani prikazu
- * int parseStatement(FILE *file, tFunctionData *functionRecord)
+ * int parseStatement(FILE *file, tCompileContext *context)
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context        Kontext prekladu zpracovavane funkce
  * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseStatementList(FILE *file, tFunctionData *functionRecord)
+ecode parseStatementList(FILE *file, tCompileContext *context)
 {
 	ecode error;
 	Token currentToken;
@@ -629,7 +977,7 @@ ecode parseStatementList(FILE *file, tFunctionData *functionRecord)
 
 		// -------------- Analyza prikazu --------------------------------------
 		returnToken(currentToken);
-		error = parseStatement(file, functionRecord);
+		error = parseStatement(file, context);
 		if (error)
 			return error;
 
@@ -645,10 +993,10 @@ ecode parseStatementList(FILE *file, tFunctionData *functionRecord)
  * Syntakticka analyza prikazu. Pro jednotlive prikazy vola prislusne funkce
  * pro jejich syntaktickou analyzu
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context        Kontext prekladu zpracovavane funkce
  * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseStatement(FILE *file, tFunctionData *functionRecord)
+ecode parseStatement(FILE *file, tCompileContext *context)
 {
 	Token currentToken;
 	ecode error;
@@ -665,25 +1013,25 @@ ecode parseStatement(FILE *file, tFunctionData *functionRecord)
 	{
 		// -------------- Analyza prikazu if -------------------------------------
 		returnToken(currentToken);
-		error = parseIf(file, functionRecord);
+		error = parseIf(file, context);
 	}
 	else if (isWhile(currentToken.type))
 	{
 		// -------------- Analyza prikazu while ----------------------------------
 		returnToken(currentToken);
-		error = parseWhile(file, functionRecord);
+		error = parseWhile(file, context);
 	}
 	else if (isReturn(currentToken.type))
 	{
 		// -------------- Analyza prikazu return ---------------------------------
 		returnToken(currentToken);
-		error = parseReturn(file, functionRecord);
+		error = parseReturn(file, context);
 	}
 	else if (isIdentifier(currentToken.type))
 	{
 		// -------------- Analyza prikazu prirazeni ------------------------------
 		returnToken(currentToken);
-		error = parseAssignment(file, functionRecord);
+		error = parseAssignment(file, context);
 	}
 	else if (isEOL(currentToken.type))
 	{
@@ -707,22 +1055,18 @@ ecode parseStatement(FILE *file, tFunctionData *functionRecord)
  * S vyuzitim pomocneho zasobniku pro navesti generuje navesti pro skoky
  * v ramci podminky - prvni skok na telo else, druhy skok na konec tela else
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context        Kontext prekladu zpracovavane funkce
  * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseIf(FILE *file, tFunctionData *functionRecord)
+ecode parseIf(FILE *file, tCompileContext *context)
 {
 	Token currentToken;
 	ecode error;
 	int numberOfTemporaryItems;
 	int *condition;
 
-	tTableItem *label;
-
-	String *labelElseName;
-	String *labelEndName;
-	tIListItem **labelElse;
-	tIListItem **labelEnd;
+	int labelElse;
+	int labelEnd;
 
 	// -------------- Token if ---------------------------------------------------
 	currentToken = getToken(file);
@@ -732,32 +1076,26 @@ ecode parseIf(FILE *file, tFunctionData *functionRecord)
 		return determineError(currentToken.type);
 	}
 
-	// -------------- Vygeneruje se navesti pro skok na else ---------------------
-	labelElseName = generateLabelName();
-	if (labelElseName == NULL)
-		return ERR_MEMORY;
-	// -------------- Ulozi navesti do TS ----------------------------------------
-	error = insertItem(functionRecord->varTabHead, labelElseName, ITEM_LABEL, NULL);
+	// -------------- Na zasobnik navesti se vlozi navesti za telem else --------
+	// -------------- a nad nej navesti pro skok na else -------------------------
+	error = generateLabel(context, &labelEnd);
 	if (error)
-	{
-		deallocString(labelElseName);
 		return error;
-	}
 
-	// -------------- Na zasobnik navesti ulozi ukazatel na data navesti ---------
-	label = searchItem(functionRecord->varTabHead, labelElseName);
-	labelElse = (tIListItem **)  &(label->data);
+	error = generateLabel(context, &labelElse);
+	if (error)
+		return error;
 
 
 	// -------------- Vyhodnoceni vyrazu podminky --------------------------------
-	error = parseExpression(file, instructionList, functionRecord->varTabHead, &condition, &numberOfTemporaryItems);
+	error = parseExpression(file, context->instructions, context->function->varTabHead, &condition, &numberOfTemporaryItems);
 	if (error)
 		return error;
 
 	// TODO provest optimalizaci docasnych promennych - snizit pocet prvku TS a generovat instrukce pro mazani
 	// Instrukce pro preskoceni tela if pokud neni splnena podminka
 	// -------------- Vygeneruje se instrukce pro skok na telo else --------------
-	error = generateAndInsertInstruction(instructionList, INSTR_IFGOTO, labelElse, condition, NULL);
+	error = generateJump(context, INSTR_IFGOTO, labelElse, condition);
 	if (error)
 		return error;
 
@@ -771,7 +1109,7 @@ ecode parseIf(FILE *file, tFunctionData *functionRecord)
 	}
 
 	// -------------- Analyza sekvence prikazu v tele if -------------------------
-	error = parseStatementList(file, functionRecord);
+	error = parseStatementList(file, context);
 	if (error)
 		return error;
 
@@ -793,33 +1131,21 @@ ecode parseIf(FILE *file, tFunctionData *functionRecord)
 	}
 
 
-	// -------------- Vygeneruje jmeno pro navesti a vlozi ho do TS --------------
-	labelEndName = generateLabelName();
-	error = insertItem(functionRecord->varTabHead, labelEndName, ITEM_LABEL, NULL);
-	if (error)
-	{
-		deallocString(labelEndName);
-		return error;
-	}
-	// -------------- Na zasobnik se ulozi ukazatel na nove navesti --------------
-	label = searchItem(functionRecord->varTabHead, labelEndName);
-	labelEnd = (tIListItem **) &(label->data);
-
 	// -------------- Vygeneruje se instrukce pro skok za telo else --------------
-	error = generateAndInsertInstruction(instructionList, INSTR_GOTO, labelEnd, NULL, NULL);
+	error = generateJump(context, INSTR_GOTO, labelEnd, NULL);
 	if (error)
 		return error;
 
 	// -------------- Vygeneruje se instrukce s navestim pro telo else -----------
-	error = generateAndInsertInstruction(instructionList, INSTR_LABEL, NULL, NULL, NULL);
+	error = generateAndInsertInstruction(context->instructions, INSTR_LABEL, NULL, NULL, NULL);
 	if (error)
 		return error;
 
-	// -------------- Nastavi ukazatel skoku na danou instrukci ------------------
-	*labelElse = tIListGetLast(instructionList);
+	// -------------- Navesti else z vrcholu zasobniku ukaze na instrukci --------
+	resolveLabel(context);
 
 	// -------------- Analyza sekvence prikazu v tele else -----------------------
-	error = parseStatementList(file, functionRecord);
+	error = parseStatementList(file, context);
 	if (error)
 		return error;
 
@@ -840,12 +1166,12 @@ ecode parseIf(FILE *file, tFunctionData *functionRecord)
 	}
 
 	// -------------- Vygeneruje se instrukce navesti za telem else --------------
-	error = generateAndInsertInstruction(instructionList, INSTR_LABEL, NULL, NULL, NULL);
+	error = generateAndInsertInstruction(context->instructions, INSTR_LABEL, NULL, NULL, NULL);
 	if (error)
 		return error;
 
-	// -------------- Nastavi ukazatel skoku na danou instrukci ------------------
-	*labelEnd = tIListGetLast(instructionList);
+	// -------------- Navesti konce z vrcholu zasobniku ukaze na instrukci ------
+	resolveLabel(context);
 
 	return ERR_OK;
 }
@@ -859,21 +1185,18 @@ ecode parseIf(FILE *file, tFunctionData *functionRecord)
  * S vyuzitim pomocneho zasobniku pro navesti generuje navesti pro skoky
  * v ramci cyklu - prvni skok za telo while, druhy skok pred kontrolu podminky
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context        Kontext prekladu zpracovavane funkce
  * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseWhile(FILE *file, tFunctionData *functionRecord)
+ecode parseWhile(FILE *file, tCompileContext *context)
 {
 	Token currentToken;
 	ecode error;
 	int numberOfTemporaryItems;
 	int *condition; // Ukazatel na offset vysledku vyrazu v podmince
 
-	String *labelConditionName;
-	String *labelEndName;
-	tTableItem *label;
-	tIListItem **labelCondition;
-	tIListItem **labelEnd;
+	int labelCondition;
+	int labelEnd;
 
 	// -------------- Token while ------------------------------------------------
 	currentToken = getToken(file);
@@ -884,49 +1207,32 @@ ecode parseWhile(FILE *file, tFunctionData *functionRecord)
 	}
 
 	// -------------- Vygeneruje se navesti pro skok na while --------------------
-	labelConditionName = generateLabelName();
-	// -------------- Ulozi navesti do TS ----------------------------------------
-	error = insertItem(functionRecord->varTabHead, labelConditionName, ITEM_LABEL, NULL);
+	error = generateLabel(context, &labelCondition);
 	if (error)
-	{
-		deallocString(labelConditionName);
 		return error;
-	}
-
-	// -------------- Ulozi se ukazatel na navesti while -------------------------
-	label = searchItem(functionRecord->varTabHead, labelConditionName);
-	labelCondition = (tIListItem **) &(label->data);
 
 	// -------------- Vygeneruje se instrukce navesti while ----------------------
-	error = generateAndInsertInstruction(instructionList, INSTR_LABEL, NULL, NULL, NULL);
+	error = generateAndInsertInstruction(context->instructions, INSTR_LABEL, NULL, NULL, NULL);
 	if (error)
 		return error;
 
-	// -------------- Nastavi ukazatel skoku na danou instrukci ------------------
-	*labelCondition = tIListGetLast(instructionList);
+	// -------------- Navesti while ukaze na danou instrukci ---------------------
+	resolveLabel(context);
 
-	// -------------- Vygeneruje se navesti pro skok za telo while ---------------
-	labelEndName = generateLabelName();
-	error = insertItem(functionRecord->varTabHead, labelEndName, ITEM_LABEL, NULL);
+	// -------------- Na zasobnik se vlozi navesti pro skok za telo while --------
+	error = generateLabel(context, &labelEnd);
 	if (error)
-	{
-		deallocString(labelEndName);
 		return error;
-	}
-
-	// -------------- Na zasobnik se ulozi ukazatel na nove navesti --------------
-	label = searchItem(functionRecord->varTabHead, labelEndName);
-	labelEnd = (tIListItem **) &(label->data);
 
 	// -------------- Vyhodnoceni vyrazu podminky --------------------------------
-	error = parseExpression(file, instructionList, functionRecord->varTabHead, &condition, &numberOfTemporaryItems);
+	error = parseExpression(file, context->instructions, context->function->varTabHead, &condition, &numberOfTemporaryItems);
 	if (error)
 		return error;
 	// TODO provest optimalizaci docasnych promennych - snizit pocet prvku TS a generovat instrukce pro mazani
 
 
 	// -------------- Vygeneruje se instrukce pro skok za telo while -------------
-	error = generateAndInsertInstruction(instructionList, INSTR_IFGOTO, labelEnd, condition, NULL);
+	error = generateJump(context, INSTR_IFGOTO, labelEnd, condition);
 	if (error)
 		return error;
 
@@ -939,7 +1245,7 @@ ecode parseWhile(FILE *file, tFunctionData *functionRecord)
 	}
 
 	// -------------- Analyza sekvence prikazu v tele while ----------------------
-	error = parseStatementList(file, functionRecord);
+	error = parseStatementList(file, context);
 	if (error)
 		return error;
 
@@ -960,17 +1266,17 @@ ecode parseWhile(FILE *file, tFunctionData *functionRecord)
 	}
 
 	// -------------- Vygeneruje instrukci pro skok na navesti pred podminkou ----
-	error = generateAndInsertInstruction(instructionList, INSTR_GOTO, labelCondition, NULL, NULL);
+	error = generateJump(context, INSTR_GOTO, labelCondition, NULL);
 	if (error)
 		return error;
 
 	// -------------- Vygeneruje se instrukce navesti za telem while -------------
-	error = generateAndInsertInstruction(instructionList, INSTR_LABEL, NULL, NULL, NULL);
+	error = generateAndInsertInstruction(context->instructions, INSTR_LABEL, NULL, NULL, NULL);
 	if (error)
 		return error;
 
-	// -------------- Nastavi ukazatel skoku na danou instrukci ------------------
-	*labelEnd = tIListGetLast(instructionList);
+	// -------------- Navesti konce z vrcholu zasobniku ukaze na instrukci ------
+	resolveLabel(context);
 
 	return ERR_OK;
 }
@@ -981,10 +1287,10 @@ ecode parseWhile(FILE *file, tFunctionData *functionRecord)
  * return expr EOL
  * Generuje skok na posledni instrukci funkce
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context        Kontext prekladu zpracovavane funkce
  * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseReturn(FILE *file, tFunctionData *functionRecord)
+ecode parseReturn(FILE *file, tCompileContext *context)
 {
 	Token currentToken;
 	ecode error;
@@ -1003,7 +1309,7 @@ ecode parseReturn(FILE *file, tFunctionData *functionRecord)
 
 
 	// -------------- Vyhodnoceni vyrazu -----------------------------------------
-	error = parseExpression(file, instructionList, functionRecord->varTabHead, &expression, &numberOfTemporaryItems);
+	error = parseExpression(file, context->instructions, context->function->varTabHead, &expression, &numberOfTemporaryItems);
 	// TODO: Optimalizace poctu pomocnych promennych
 	if (error)
 		return error;
@@ -1012,11 +1318,11 @@ ecode parseReturn(FILE *file, tFunctionData *functionRecord)
 	if (returnName == NULL)
 		return ERR_MEMORY;
 
-	varItem = searchItem(functionRecord->varTabHead, returnName);
+	varItem = symbolIndexSearch(context->function->varTabHead, returnName);
 	// Pokud se nenajde, jedna se o pseudo funkci $main - neni kam vracet
 	if (varItem != NULL)
 	{
-		error = generateAndInsertInstruction(instructionList, INSTR_MOV_STACK, varItem->data, expression, NULL);
+		error = generateAndInsertInstruction(context->instructions, INSTR_MOV_STACK, varItem->data, expression, NULL);
 		if (error)
 		{
 			deallocString(returnName);
@@ -1026,7 +1332,7 @@ ecode parseReturn(FILE *file, tFunctionData *functionRecord)
 
 	deallocString(returnName);
 	// Skok na konec funkce
-	error = generateAndInsertInstruction(instructionList, INSTR_GOTO, &(functionRecord->lastInstruction), NULL, NULL);
+	error = generateJump(context, INSTR_GOTO, RETURN_LABEL, NULL);
 	if (error)
 		return error;
 
@@ -1045,13 +1351,13 @@ ecode parseReturn(FILE *file, tFunctionData *functionRecord)
 /**
  * Syntakticka analyza prikazu prirazeni
  * Ulozi promennou na leve strane do TS a zavola funkci
- * parseRightHandSide(FILE *file, tFunctionData *functionRecord, int **offset, int *numberOfTemporaryItems)
+ * parseRightHandSide(FILE *file, tCompileContext *context, int **offset, int *numberOfTemporaryItems)
  * pro zpracovani prave strany prirazeni
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context        Kontext prekladu zpracovavane funkce
  * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseAssignment(FILE *file, tFunctionData *functionRecord)
+ecode parseAssignment(FILE *file, tCompileContext *context)
 {
 
 	Token currentToken;
@@ -1060,6 +1366,7 @@ ecode parseAssignment(FILE *file, tFunctionData *functionRecord)
 	int *offsetRHS;
 	int numberOfTemporaryItems;
 	tTableItem *varItem;
+	const tName *identifier;	// Jmeno z tabulky jmen
 
 	// -------------- Token identifikator ----------------------------------------
 	currentToken = getToken(file);
@@ -1071,28 +1378,28 @@ ecode parseAssignment(FILE *file, tFunctionData *functionRecord)
 
 
 	// -------------- Kontrola, zda neni identifikator v tabulce funkci ----------
-	if (searchItem(functionTable, currentToken.item) != NULL)
+	identifier = symbolIndexName(currentToken.item);
+	if (symbolIndexFind(functionTable, identifier) != NULL)
 	{   // -------------- Identifikator definovan jako funkce -> semanticka chyba
 		deallocToken(currentToken);
 		return ERR_SEMANTICS_OTHER;
 	}
 
 	// -------------- Pokud neni promenna v TS tak ji tam pridej -----------------
-	varItem = searchItem(functionRecord->varTabHead, currentToken.item);
+	varItem = symbolIndexFind(context->function->varTabHead, identifier);
 	if (varItem == NULL)
 	{
-		offset = malloc(sizeof(int));
+		offset = compileArenaAlloc(sizeof(int));
 		if (offset == NULL)
 		{
 			deallocToken(currentToken);
 			return ERR_MEMORY;
 		}
-		*offset = functionRecord->varTabHead->itemCount + 1;
-		error = insertItem(functionRecord->varTabHead, currentToken.item, ITEM_VAR, offset);
+		*offset = context->function->varTabHead->itemCount + 1;
+		error = symbolIndexInsert(context->function->varTabHead, currentToken.item, ITEM_VAR, offset);
 		if (error)
 		{
 			deallocToken(currentToken);
-			free(offset);
 			return error;
 		}
 	}
@@ -1111,12 +1418,12 @@ ecode parseAssignment(FILE *file, tFunctionData *functionRecord)
 	}
 
 	// -------------- Zpracovat pravou stranu prirazeni --------------------------
-	error = parseRightHandSide(file, functionRecord, &offsetRHS, &numberOfTemporaryItems);
+	error = parseRightHandSide(file, context, &offsetRHS, &numberOfTemporaryItems);
 	if (error)
 		return error;
 	// TODO: optimalizace pomocnych promennych
 
-	error = generateAndInsertInstruction(instructionList, INSTR_MOV_STACK, offset, offsetRHS, NULL);
+	error = generateAndInsertInstruction(context->instructions, INSTR_MOV_STACK, offset, offsetRHS, NULL);
 	if (error)
 		return error;
 
@@ -1136,12 +1443,12 @@ ecode parseAssignment(FILE *file, tFunctionData *functionRecord)
  * Analyza prave strany prirazeni, na zaklad max. 2 tokenu se rozhodne, zda se
  * jedna o vyraz, volani funkce nebo vyber podretezce
  * @param  file                   Zdrojovy soubor
- * @param  functionRecord         Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context                Kontext prekladu zpracovavane funkce
  * @param  offset                 Pointer na pointer pro ulozeni offsetu vysledku prave strany
  * @param  numberOfTemporaryItems Pocet docasnych promennych (slouzi k optimalizaci)
  * @return                        ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseRightHandSide(FILE *file, tFunctionData *functionRecord, int **offset, int *numberOfTemporaryItems)
+ecode parseRightHandSide(FILE *file, tCompileContext *context, int **offset, int *numberOfTemporaryItems)
 {
 	ecode error;
 	Token currentToken, previousToken;
@@ -1152,7 +1459,7 @@ ecode parseRightHandSide(FILE *file, tFunctionData *functionRecord, int **offset
 	if (isLeftBracket(currentToken.type))
 	{
 		returnToken(currentToken);
-		error = parseExpression(file, instructionList, functionRecord->varTabHead, offset, numberOfTemporaryItems);
+		error = parseExpression(file, context->instructions, context->function->varTabHead, offset, numberOfTemporaryItems);
 		if (error)
 			return error;
 		// TODO: optimalizace docasnych promennych
@@ -1168,7 +1475,7 @@ ecode parseRightHandSide(FILE *file, tFunctionData *functionRecord, int **offset
 		{
 			returnToken(currentToken);
 			returnToken(previousToken);
-			error = parseFunctionCall(file, functionRecord, offset, numberOfTemporaryItems);
+			error = parseFunctionCall(file, context, offset, numberOfTemporaryItems);
 			if (error)
 				return error;
 		}
@@ -1177,7 +1484,7 @@ ecode parseRightHandSide(FILE *file, tFunctionData *functionRecord, int **offset
 		{
 			returnToken(currentToken);
 			returnToken(previousToken);
-			error = parseSubstring(file, functionRecord, offset, numberOfTemporaryItems);
+			error = parseSubstring(file, context, offset, numberOfTemporaryItems);
 			if (error)
 				return error;
 		}
@@ -1186,7 +1493,7 @@ ecode parseRightHandSide(FILE *file, tFunctionData *functionRecord, int **offset
 		{
 			returnToken(currentToken);
 			returnToken(previousToken);
-			error = parseExpression(file, instructionList, functionRecord->varTabHead, offset, numberOfTemporaryItems);
+			error = parseExpression(file, context->instructions, context->function->varTabHead, offset, numberOfTemporaryItems);
 			if (error)
 				return error;
 		}
@@ -1205,15 +1512,17 @@ ecode parseRightHandSide(FILE *file, tFunctionData *functionRecord, int **offset
  * Syntakticka analyza volani funkce
  * Provadi syntaktickou analyzu volani funkce a pripojene semantikcke akce pro
  * kontrolu, zda je identifikator funkce v tabulce funkci
- * Generuje instrukce pro volani funkce, vlozeni navratove hodnoty na zasobnik,
- * a nacteni navratove hodnoty ze zasobniku
+ * Pro uzivatelske funkce generuje instrukce pro vlozeni parametru a navratove
+ * hodnoty na zasobnik, volani funkce a nacteni navratove hodnoty ze zasobniku
+ * Vestavene funkce se volaji primo instrukci, ktera dostane operandy
+ * parametru a offset vysledku
  * @param  file                   Zdrojovy soubor
- * @param  functionRecord         Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context                Kontext prekladu zpracovavane funkce
  * @param  offset                 Pointer na pointer pro ulozeni offsetu vysledku prave strany
  * @param  numberOfTemporaryItems Pocet docasnych promennych (slouzi k optimalizaci)
  * @return                        ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseFunctionCall(FILE *file, tFunctionData *functionRecord, int **offset, int *numberOfTemporaryItems)
+ecode parseFunctionCall(FILE *file, tCompileContext *context, int **offset, int *numberOfTemporaryItems)
 {
 	ecode error;
 
@@ -1222,6 +1531,7 @@ ecode parseFunctionCall(FILE *file, tFunctionData *functionRecord, int **offset,
 	String *functionName;
 	tTableItem *calledFunction;
 	ParsedFunction function;
+	tOperandList *params = NULL;
 
 	// -------------- Token identifikator ----------------------------------------
 	currentToken = getToken(file);
@@ -1244,65 +1554,175 @@ ecode parseFunctionCall(FILE *file, tFunctionData *functionRecord, int **offset,
 	}
 
 	// -------------- Nalezeni zaznamu funkce ------------------------------------
-	calledFunction = searchItem(functionTable, functionName);
+	// -------------- (vestavenou funkci urci index tabulky funkci) --------------
+	calledFunction = symbolIndexSearchFunction(functionName, &function);
 
 	// -------------- Nedefinovana funkce ----------------------------------------
 	if (calledFunction == NULL)
 	{
-		deallocString(functionName);
-		return ERR_SEMANTICS_UNDEFINED_FUNCTION;
-	}
-
-	// -------------- Zjisteni, jaka funkce se zpracovava ------------------------
-	if (strcmp(functionName->data, "typeOf") == 0)
-	{
-		function = FUNCTION_TYPEOF;
-	}
-	else if (strcmp(functionName->data, "print") == 0)
-	{
-		function = FUNCTION_PRINT;
-	}
-	else
-	{
-		function = FUNCTION_OTHER;
+		deallocString(functionName);
+		return ERR_SEMANTICS_UNDEFINED_FUNCTION;
 	}
 
 	deallocString(functionName);
 
 	// -------------- Zpracovani parametru ---------------------------------------
-	error = parseFunctionCallParams(file, functionRecord, function, ((tFunctionData *) calledFunction->data)->paramsCount);
+	error = parseFunctionCallParams(file, context, function, ((tFunctionData *) calledFunction->data)->paramsCount, &params);
 	if (error)
+	{
+		free(params);
 		return error;
+	}
 
 	// -------------- Token prava zavorka ----------------------------------------
 	currentToken = getToken(file);
 	if (!isRightBracket(currentToken.type))
 	{   // -------------- Pro token neni pravidlo --------------------------------
 		deallocToken(currentToken);
+		free(params);
 		return determineError(currentToken.type);
 	}
 
-	 // -------------- Vytvoreni docasne promenne pro navratovou hodnotu ----------
-    error = generateAndInsertTemporaryVariable(instructionList, functionRecord->varTabHead, NIL, NULL, offset);
-    if (error)
-            return error;
+	// -------------- Vestavena funkce se vola primo instrukci -------------------
+	if (function != FUNCTION_OTHER)
+		return generateBuiltinCall(context, function, params, offset);
+
+	// -------------- Vlozeni parametru na zasobnik ------------------------------
+	for (int i = 0; i < params->count; i++)
+	{
+		// Konstanta se vklada bez kopirovani, promenna jako kopie
+		if (isConstantOperand(params->operands[i]))
+			error = generateAndInsertInstruction(context->instructions, INSTR_PUSH, params->operands[i], NULL, NULL);
+		else
+			error = generateAndInsertInstruction(context->instructions, INSTR_PUSH_STACK, params->operands[i], NULL, NULL);
+
+		if (error)
+		{
+			free(params);
+			return error;
+		}
+	}
+	free(params);
+
+	// -------------- Konstanta nil pro misto navratove hodnoty -----------------
+	error = generateAndInsertTemporaryVariable(context->instructions, context->function->varTabHead, NIL, NULL, offset);
+	if (error)
+		return error;
 
-    // -------------- Vlozeni docasne promenne na zasobnik -----------------------
-	error = generateAndInsertInstruction(instructionList, INSTR_PUSH_STACK, *offset, NULL, NULL);
+	// -------------- Vlozeni kopie konstanty na zasobnik ------------------------
+	// -------------- (volana funkce do ni zapisuje, nesmi byt sdilena) ---------
+	error = generateAndInsertInstruction(context->instructions, INSTR_PUSH_STACK, *offset, NULL, NULL);
 	if (error)
 		return error;
 
 	// -------------- Generovani instrukce pro zavolani funkce -------------------
+	error = generateAndInsertInstruction(context->instructions, INSTR_CALL, calledFunction->data, NULL, NULL);
+	if (error)
+		return error;
 
-	error = generateAndInsertInstruction(instructionList, INSTR_CALL, calledFunction->data, NULL, NULL);
+	// -------------- Vytvoreni docasne promenne pro navratovou hodnotu ----------
+	error = generateTemporaryOffset(context->function->varTabHead, offset);
 	if (error)
 		return error;
 
 	// -------------- Nacteni navratove hodnoty ze zasobniku ---------------------
-	error = generateAndInsertInstruction(instructionList, INSTR_POP, *offset, NULL, NULL);
+	error = generateAndInsertInstruction(context->instructions, INSTR_POP, *offset, NULL, NULL);
+	if (error)
+		return error;
+
+
+	return ERR_OK;
+}
+
+/**
+ * Generovani instrukce vestavene funkce. Vysledek se uklada do nove docasne
+ * promenne, parametry jsou operandy instrukce (offset nebo konstanta)
+ * Funkce print a find dostanou cely seznam operandu, find s konstantnim
+ * podretezcem navic tabulku posunu pro dane misto volani
+ * @param  context        Kontext prekladu zpracovavane funkce
+ * @param  function       Volana vestavena funkce
+ * @param  params         Seznam operandu parametru (uvolni se, pripadne se
+ *                        presune do areny prekladu)
+ * @param  offset         Pointer na pointer pro ulozeni offsetu vysledku
+ * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode generateBuiltinCall(tCompileContext *context, ParsedFunction function, tOperandList *params, int **offset)
+{
+	ecode error;
+	tSearchTable *searchTable = NULL;
+	tOperandArray *operands;
+	String *needle;
+
+	// -------------- Vytvoreni docasne promenne pro vysledek --------------------
+	error = generateTemporaryOffset(context->function->varTabHead, offset);
 	if (error)
+	{
+		free(params);
 		return error;
+	}
+
+	switch (function)
+	{
+		case FUNCTION_INPUT:
+			free(params);
+			return generateAndInsertInstruction(context->instructions, INSTR_INPUT, *offset, NULL, NULL);
+
+		case FUNCTION_NUMERIC:
+		case FUNCTION_TYPEOF:
+		case FUNCTION_LEN:
+		case FUNCTION_SORT:
+			// Funkce s jednim parametrem dostane primo jeho operand
+			error = generateAndInsertInstruction(context->instructions,
+						function == FUNCTION_NUMERIC ? INSTR_NUMERIC :
+						function == FUNCTION_TYPEOF ? INSTR_TYPEOF :
+						function == FUNCTION_LEN ? INSTR_LEN : INSTR_SORT,
+						*offset, params->operands[0], NULL);
+			free(params);
+			return error;
+
+		case FUNCTION_FIND:
+			// -------------- Konstantni podretezec funkce find ------------------
+			if (isConstantOperand(params->operands[1]) && constantOperandValue(params->operands[1])->semantic == STRING)
+			{
+				needle = constantOperandValue(params->operands[1])->value;
+				searchTable = searchTableCreate(needle->data, needle->length);
+				if (searchTable == NULL)
+				{
+					free(params);
+					return ERR_MEMORY;
+				}
+			}
+
+			// Seznam se prevede na pole operandu v arene prekladu
+			operands = tOperandListCompact(params);
+			if (operands == NULL)
+			{
+				free(searchTable);
+				return ERR_MEMORY;
+			}
+
+			error = generateAndInsertInstruction(context->instructions, INSTR_FIND, *offset, operands, searchTable);
+			break;
+
+		case FUNCTION_PRINT:
+			operands = tOperandListCompact(params);
+			if (operands == NULL)
+				return ERR_MEMORY;
+
+			error = generateAndInsertInstruction(context->instructions, INSTR_PRINT, *offset, operands, NULL);
+			break;
+
+		default:
+			free(params);
+			return ERR_INTERNAL;
+	}
 
+	// Seznam operandu je v arene, tabulka posunu se registruje az s instrukci
+	if (error)
+	{
+		free(searchTable);
+		return error;
+	}
 
 	return ERR_OK;
 }
@@ -1311,27 +1731,33 @@ ecode parseFunctionCall(FILE *file, tFunctionData *functionRecord, int **offset,
  * {Provadi syntaktickou analyzu parametru volane funkce
  * a kotroluje, zda nejsou parametry volani funkce nazvy funkci (s vyjimkou
  * funkce typeOf).
- * Generuje instrukce triadresneho kodu pro vlozeni parametru na zasobnik
- * Pokud je parametru mene, nez v definici funkce, na zasobnik vlozi
- * odpovidajici pocet vychozich promennych typu NIL
- * Pokud je parametru vice, nez v definici funkce, na zasobnik se vlozi
+ * Sestavi seznam operandu parametru (offset promenne nebo konstanta)
+ * Pokud je parametru mene, nez v definici funkce, doplni seznam
+ * odpovidajicim poctem konstant nil
+ * Pokud je parametru vice, nez v definici funkce, do seznamu se vlozi
  * jen definovany pocet, ostatni parametry vlozeny nejsou, ale je provedena
- * jejich syntakticka analyza
+ * jejich syntakticka analyza. Funkce print dostane vsechny parametry
  * Pro zpracovani parametru termu pouziva funkci
- * int parseParamsTerm(FILE *file, tFunctionData *functionRecord, ParsedFunction function, int paramsToPush, int *pushedParams)
+ * int parseParamsTerm(FILE *file, tCompileContext *context, ParsedFunction function, void **operand)
  *
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context        Kontext prekladu zpracovavane funkce
  * @param  function       Zpracovavana funkce
- * @param  paramsToPush   Pocet parametru, ktere ma se maji vlozit na zasobnik
+ * @param  paramsToPush   Pocet parametru v definici funkce
+ * @param  params         Ukazatel pro ulozeni seznamu operandu parametru
  * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseFunctionCallParams(FILE *file, tFunctionData *functionRecord, ParsedFunction function, int paramsToPush)
+ecode parseFunctionCallParams(FILE *file, tCompileContext *context, ParsedFunction function, int paramsToPush, tOperandList **params)
 {
 	ecode error;
 	Token currentToken;
-	int pushedParams = 0;
-	tVariable *paramVar;
+	void *operand;
+	tConstant *nilConstant;
+
+	// -------------- Prazdny seznam operandu ------------------------------------
+	error = tOperandListInit(params);
+	if (error)
+		return error;
 
 	// -------------- Token reprezentujici term ----------------------------------
 	currentToken = getToken(file);
@@ -1341,87 +1767,51 @@ ecode parseFunctionCallParams(FILE *file, tFunctionData *functionRecord, ParsedF
 		return determineError(currentToken.type);
 	}
 
-	// -------------- Token prava zavorka ------------------------------------
-	if (isRightBracket(currentToken.type))
+	returnToken(currentToken);
+
+	// -------------- Parametry az po pravou zavorku -----------------------------
+	if (!isRightBracket(currentToken.type))
 	{
-		// Doplneni parametru pokud chybi
-		while (pushedParams < paramsToPush && function != FUNCTION_PRINT)
+		do
 		{
-			// TODO: Zaradit do nejake struktury pro literaly
-			error = createNewVariable(&paramVar, NIL, NULL);
+			// -------------- Parametr funkce ------------------------------------
+			error = parseParamsTerm(file, context, function, &operand);
 			if (error)
 				return error;
 
-			error = generateAndInsertInstruction(instructionList, INSTR_PUSH, paramVar, NULL, NULL);
-			if (error)
-				return error;
-			pushedParams++;
-		}
-
-		returnToken(currentToken);
-		return ERR_OK;
-	}
-
-	returnToken(currentToken);
-
-	error = parseParamsTerm(file, functionRecord, function, paramsToPush, &pushedParams);
-	if (error)
-		return error;
-
-	currentToken = getToken(file);
-
-	while (!isRightBracket(currentToken.type))
-	{
-		// -------------- Token carka --------------------------------------------
-		if (!isComma(currentToken.type))
-		{   // -------------- Pro token neni pravidlo ----------------------------
-			deallocToken(currentToken);
-			return determineError(currentToken.type);
-		}
+			if ((*params)->count < paramsToPush || function == FUNCTION_PRINT)
+			{
+				error = tOperandListAppend(params, operand);
+				if (error)
+					return error;
+			}
 
-		// -------------- Parametr funkce ----------------------------------------
-		error = parseParamsTerm(file, functionRecord, function, paramsToPush, &pushedParams);
-		if (error)
-			return error;
+			// Nacti dalsi token
+			currentToken = getToken(file);
+			if (!isComma(currentToken.type) && !isRightBracket(currentToken.type))
+			{   // -------------- Pro token neni pravidlo ------------------------
+				deallocToken(currentToken);
+				return determineError(currentToken.type);
+			}
+		} while (isComma(currentToken.type));
 
-		// Nacti dalsi token
-		currentToken = getToken(file);
+		// -------------- Token je prava zavorka - konec parametru ---------------
+		returnToken(currentToken);
 	}
 
-	// -------------- Token je prava zavorka - konec parametru -------------------
-	returnToken(currentToken);
-
 	// Doplneni parametru pokud chybi
-	while (pushedParams < paramsToPush && function != FUNCTION_PRINT)
-	{
-		// TODO: Zaradit do nejake struktury pro literaly
-		error = createNewVariable(&paramVar, NIL, NULL);
-		if (error)
-			return error;
-
-		error = generateAndInsertInstruction(instructionList, INSTR_PUSH, paramVar, NULL, NULL);
-		if (error)
-			return error;
-		pushedParams++;
-	}
-
-	// Pro fukci print prida za parametry promennou s poctem parametru
-	if (function == FUNCTION_PRINT)
+	if ((*params)->count < paramsToPush && function != FUNCTION_PRINT)
 	{
-		double *tmpDbl;
-		tmpDbl = malloc(sizeof(double));
-		if (tmpDbl == NULL)
-			return ERR_MEMORY;
-		*tmpDbl = pushedParams;
-		// TODO: Zaradit do nejake struktury pro literaly
-		error = createNewVariable(&paramVar, NUMERIC, tmpDbl);
+		error = constantPoolInsert(NIL, NULL, &nilConstant);
 		if (error)
 			return error;
 
-		error = generateAndInsertInstruction(instructionList, INSTR_PUSH, paramVar, NULL, NULL);
-		if (error)
-			return error;
-		pushedParams++;
+		while ((*params)->count < paramsToPush)
+		{
+			error = tOperandListAppend(params, nilConstant);
+			if (error)
+				return error;
+		}
 	}
 
 	return ERR_OK;
@@ -1431,20 +1821,21 @@ ecode parseFunctionCallParams(FILE *file, tFunctionData *functionRecord, ParsedF
  * Funkce poskytujici semanticke akce pro kontrolu, zda je indentifikator
  * v TS dane funkce, pripadne zda se jedna o identifikator funkce (chyba
  * krome funkce typeOf)
- * Zaroven generuje triadresny kod pro vkladani termu na zasobnik
+ * Vraci operand termu - offset promenne, nebo konstantu pro literal
+ * a identifikator funkce
  * @param  file           Zdrojovy soubor
- * @param  functionRecord Zaznam z tabulky funkci pro zpracovavanou funkci
- * @param  function       Zpracovavana funkce (PRINT, TYPEOF, OTHER)
- * @param  paramsToPush   Pocet parametru, ktere se maji vlozit na zasobnik
- * @param  pushedParams   Pocet parametru, ktere uz byly vlozeny na zasobnik
+ * @param  context        Kontext prekladu zpracovavane funkce
+ * @param  function       Zpracovavana funkce
+ * @param  operand        Ukazatel pro ulozeni operandu termu
  * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseParamsTerm(FILE *file, tFunctionData *functionRecord, ParsedFunction function, int paramsToPush, int *pushedParams)
+ecode parseParamsTerm(FILE *file, tCompileContext *context, ParsedFunction function, void **operand)
 {
 	ecode error;
 	Token currentToken;
-	tVariable *paramVar;
+	tConstant *constant;
 	tTableItem *varRecord;
+	const tName *identifier;	// Jmeno z tabulky jmen
 
 	currentToken = getToken(file);
 
@@ -1452,69 +1843,40 @@ ecode parseParamsTerm(FILE *file, tFunctionData *functionRecord, ParsedFunction
 	if (isIdentifier(currentToken.type))
 	{
 		// -------------- Pokud neni funkce typeOf, tak nesmi byt id funkce ------
-		if (searchItem(functionTable, currentToken.item) != NULL)
+		identifier = symbolIndexName(currentToken.item);
+		if (symbolIndexFind(functionTable, identifier) != NULL)
 		{
 			deallocToken(currentToken);
 			if (function != FUNCTION_TYPEOF)
 				return ERR_SEMANTICS_OTHER;
-			else
-			{
-				if ((*pushedParams) < paramsToPush)
-				{
-					// TODO: Zaradit do nejake struktury pro literaly
-					// -------------- Promenna pro parametr --------------------------
-					error = createNewVariable(&paramVar, FUNCTION, NULL);
-					if (error)
-						return error;
-
-					// -------------- Vlozeni parametru na zasobnik ------------------
-					error = generateAndInsertInstruction(instructionList, INSTR_PUSH, paramVar, NULL, NULL);
-					if (error)
-						return error;
-					(*pushedParams)++;
-				}
-			}
+
+			// -------------- Konstanta typu funkce ------------------------------
+			error = constantPoolInsert(FUNCTION, NULL, &constant);
+			if (error)
+				return error;
+			*operand = constant;
 		}
 		else
 		{
 			// -------------- Identifikator neni funkce -> hledame v TS --------------
-			varRecord = searchItem(functionRecord->varTabHead, currentToken.item);
+			varRecord = symbolIndexFind(context->function->varTabHead, identifier);
 			deallocToken(currentToken);
 			// -------------- Identifikator nebyl nalezen ----------------------------
 			if (varRecord == NULL)
 			{
 				return ERR_SEMANTICS_UNDEFINED_VARIABLE;
 			}
-			// -------------- Identifikator nalezen, vlozi se na zasobnik ------------
-			else
-			{
-				if ((*pushedParams) < paramsToPush || function == FUNCTION_PRINT)
-				{
-					error = generateAndInsertInstruction(instructionList, INSTR_PUSH_STACK, varRecord->data, NULL, NULL);
-					if (error)
-						return error;
-					(*pushedParams)++;
-				}
-			}
+			// -------------- Identifikator nalezen, operandem je jeho offset --------
+			*operand = varRecord->data;
 		}
 	}
 	else if (isLiteral(currentToken.type))
 	{
-		// TODO: Zaradit do nejake struktury pro literaly
-		if ((*pushedParams) < paramsToPush || function == FUNCTION_PRINT)
-		{
-			error = createNewVariable(&paramVar, tokenTypeToSemanticType(currentToken.type), currentToken.item);
-			if (error)
-				return error;
-			error = generateAndInsertInstruction(instructionList, INSTR_PUSH, paramVar, NULL, NULL);
-			if (error)
-				return error;
-			(*pushedParams)++;
-		}
-		else
-		{
-			deallocToken(currentToken);
-		}
+		// -------------- Literal se vlozi do tabulky konstant -------------------
+		error = constantPoolInsert(tokenTypeToSemanticType(currentToken.type), currentToken.item, &constant);
+		if (error)
+			return error;
+		*operand = constant;
 	}
 	else
 	{
@@ -1531,19 +1893,19 @@ ecode parseParamsTerm(FILE *file, tFunctionData *functionRecord, ParsedFunction
  * na prislusne offsety a vytvari pomocnou strukturu tRange, ktera obsahuje
  * offsety hranic podretezce, pokud je nektera z hranic vynechana, jeji offset je NULL
  * @param  file                   Zdrojovy soubor
- * @param  functionRecord         Zaznam z tabulky funkci pro zpracovavanou funkci
+ * @param  context                Kontext prekladu zpracovavane funkce
  * @param  offset                 Pointer na pointer pro ulozeni offsetu vysledku prave strany
  * @param  numberOfTemporaryItems Pocet docasnych promennych (slouzi k optimalizaci)
  * @return                        ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
-ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, int *numberOfTemporaryItems)
+ecode parseSubstring(FILE *file, tCompileContext *context, int **offset, int *numberOfTemporaryItems)
 {
 	ecode error;
 	Token currentToken;
 	tRange *range;
 	int *stringOffset, *rangeOffset, *beginOffset, *endOffset, *resultOffset;
 	tTableItem *varRecord;
-	String *resultName;
+	const tName *identifier;	// Jmeno z tabulky jmen
 
 	// -------------- Token reprezentujici term ----------------------------------
 	currentToken = getToken(file);
@@ -1565,14 +1927,15 @@ ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, in
 	if (isIdentifier(currentToken.type))
 	{
 		// Jedna se o identifikator funkce
-		if (searchItem(functionTable, currentToken.item) != NULL)
+		identifier = symbolIndexName(currentToken.item);
+		if (symbolIndexFind(functionTable, identifier) != NULL)
 		{
 			deallocToken(currentToken);
 			return ERR_SEMANTICS_OTHER;
 		}
 
 		// -------------- Identifikator neni funkce -> hledame v TS --------------
-		varRecord = searchItem(functionRecord->varTabHead, currentToken.item);
+		varRecord = symbolIndexFind(context->function->varTabHead, identifier);
 		deallocToken(currentToken);
 		if (varRecord != NULL)
 		{
@@ -1586,8 +1949,8 @@ ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, in
 	// -------------- Token retezec ------------------------------------------
 	else if (isString(currentToken.type))
 	{
-		error = generateAndInsertTemporaryVariable(instructionList,
-					functionRecord->varTabHead, tokenTypeToSemanticType(currentToken.type),
+		error = generateAndInsertTemporaryVariable(context->instructions,
+					context->function->varTabHead, tokenTypeToSemanticType(currentToken.type),
 					currentToken.item, &stringOffset);
 		if (error)
 			return error;
@@ -1609,14 +1972,15 @@ ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, in
 	if (isIdentifier(currentToken.type))
 	{
 		// Jedna se o identifikator funkce
-		if (searchItem(functionTable, currentToken.item) != NULL)
+		identifier = symbolIndexName(currentToken.item);
+		if (symbolIndexFind(functionTable, identifier) != NULL)
 		{
 			deallocToken(currentToken);
 			return ERR_SEMANTICS_OTHER;
 		}
 
 		// -------------- Identifikator neni funkce -> hledame v TS --------------
-		varRecord = searchItem(functionRecord->varTabHead, currentToken.item);
+		varRecord = symbolIndexFind(context->function->varTabHead, identifier);
 
 		deallocToken(currentToken);
 		if (varRecord != NULL)
@@ -1631,8 +1995,8 @@ ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, in
 	// -------------- Token reprezentujici ciselny literal -----------------
 	else if (isLiteral(currentToken.type) && isNumeric(currentToken.type))
 	{
-		error = generateAndInsertTemporaryVariable(instructionList,
-					functionRecord->varTabHead, tokenTypeToSemanticType(currentToken.type),
+		error = generateAndInsertTemporaryVariable(context->instructions,
+					context->function->varTabHead, tokenTypeToSemanticType(currentToken.type),
 					currentToken.item, &beginOffset);
 		if (error)
 			return error;
@@ -1671,14 +2035,15 @@ ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, in
 	if (isIdentifier(currentToken.type))
 	{
 		// Jedna se o identifikator funkce
-		if (searchItem(functionTable, currentToken.item) != NULL)
+		identifier = symbolIndexName(currentToken.item);
+		if (symbolIndexFind(functionTable, identifier) != NULL)
 		{
 			deallocToken(currentToken);
 			return ERR_SEMANTICS_OTHER;
 		}
 
 		// -------------- Identifikator neni funkce -> hledame v TS --------------
-		varRecord = searchItem(functionRecord->varTabHead, currentToken.item);
+		varRecord = symbolIndexFind(context->function->varTabHead, identifier);
 
 		deallocToken(currentToken);
 		if (varRecord != NULL)
@@ -1693,8 +2058,8 @@ ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, in
 	// -------------- Token reprezentujici ciselny literal --------------------
 	else if (isLiteral(currentToken.type) && isNumeric(currentToken.type))
 	{
-		error = generateAndInsertTemporaryVariable(instructionList,
-					functionRecord->varTabHead, tokenTypeToSemanticType(currentToken.type),
+		error = generateAndInsertTemporaryVariable(context->instructions,
+					context->function->varTabHead, tokenTypeToSemanticType(currentToken.type),
 					currentToken.item, &endOffset);
 		if (error)
 			return error;
@@ -1732,33 +2097,16 @@ ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, in
 	range->off1 = beginOffset;
 	range->off2 = endOffset;
 
-	error = generateAndInsertTemporaryVariable(instructionList, functionRecord->varTabHead, RANGE, range, &rangeOffset);
+	error = generateAndInsertTemporaryVariable(context->instructions, context->function->varTabHead, RANGE, range, &rangeOffset);
 	if (error)
 			return error;
 
-	// Vytvoreni zaznamu pro pomocnou promennou s vysledkem
-	resultName = generateVariableName();
-	if (resultName == NULL)
-		return ERR_MEMORY;
-	// Vypocet offsetu vysledku
-	resultOffset = malloc(sizeof(int));
-	if (resultOffset == NULL)
-	{
-		deallocString(resultName);
-		return ERR_MEMORY;
-	}
-	// Pridani promenne vysledku do TS
-	*resultOffset = functionRecord->varTabHead->itemCount + 1;
-
-	error = insertItem(functionRecord->varTabHead, resultName, ITEM_VAR, resultOffset);
+	// Vytvoreni pomocne promenne s vysledkem
+	error = generateTemporaryOffset(context->function->varTabHead, &resultOffset);
 	if (error)
-	{
-		deallocString(resultName);
-		free(resultOffset);
 		return error;
-	}
 
-	error = generateAndInsertInstruction(instructionList, INSTR_SUBSTRING, resultOffset, stringOffset, rangeOffset);
+	error = generateAndInsertInstruction(context->instructions, INSTR_SUBSTRING, resultOffset, stringOffset, rangeOffset);
 	if (error)
 		return error;
 
@@ -1768,68 +2116,6 @@ ecode parseSubstring(FILE *file, tFunctionData *functionRecord, int **offset, in
 }
 
 
-/**
- * Syntakticka analyza parametru pri prvnim pruchodu programem. Pocita parametry
- * a vrati je analyzatoru funkce.
- * @param  file        Zdrojovy soubor
- * @param  paramsCount Ukazatel na pocet parametru
- * @return             ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
- */
-ecode parseParamsFirstPass(FILE *file, int *paramsCount)
-{
-	Token currentToken;
-	// -------------- Token prava zavorka nebo identifikator --------------------
-	currentToken = getToken(file);
-	if (!isIdentifier(currentToken.type) && !isRightBracket(currentToken.type))
-	{
-		deallocToken(currentToken);
-		return determineError(currentToken.type);
-	}
-	else if (isIdentifier(currentToken.type))
-	{
-		deallocToken(currentToken);
-		(*paramsCount)++;   // Zvysi se pocitadlo parametru
-	}
-	else if (isRightBracket(currentToken.type))
-	{
-		// -------------- Token prava zavorka -----------------------------------
-		// -------------- Vrati token scanneru, protoze nepatri do pravidla -----
-		returnToken(currentToken);
-		return ERR_OK;
-	}
-
-	// -------------- Analyza dalsich parametru ----------------------------------
-
-	currentToken = getToken(file);
-	while (!isRightBracket(currentToken.type))
-	{
-		// -------------- Token carka --------------------------------------------
-		if (!isComma(currentToken.type))
-		{   // -------------- Pro token neni pravidlo ----------------------------
-			deallocToken(currentToken);
-			return determineError(currentToken.type);
-		}
-
-		// -------------- Token identifikator ------------------------------------
-		currentToken = getToken(file);
-		if (!isIdentifier(currentToken.type))
-		{   // -------------- Pro token neni pravidlo ----------------------------
-			deallocToken(currentToken);
-			return determineError(currentToken.type);
-		}
-		// Token obsahuje identifikator
-		(*paramsCount)++;
-		deallocToken(currentToken);
-		// Nacti dalsi token
-		currentToken = getToken(file);
-
-	}
-
-	// -------------- Token je prava zavorka - konec parametru -------------------
-	returnToken(currentToken);
-	return ERR_OK;
-}
-
 /**
  * Funkce pro vlozeni parametru do TS. Vypocita offset pro parametr a vlozi ho
  * do TS.
@@ -1841,33 +2127,32 @@ ecode insertParamToSymbolTable(tTableHead* symbolTable, String* name)
 {
 	int *offset;
 	ecode error;
+	const tName *identifier;	// Jmeno z tabulky jmen
 	// Token obsahuje identifikator
 	// Pridat parametr do tabulky symbolu
 	// Podle poctu parametru vypocitat offset
 	// Nebude se generovat zadna instrukce, protoze offset ukazuje na jiz existujici zaznam
 
 	// -------------- Kontrola, zda je identifikator v tabulce funkci --------
-	if (searchItem(functionTable, name) != NULL)
+	identifier = symbolIndexName(name);
+	if (symbolIndexFind(functionTable, identifier) != NULL)
 		return ERR_SEMANTICS_OTHER;
 
 	// -------------- Kontrola zda nebyl identifikator definovan -------------
-	if (searchItem(symbolTable, name) != NULL)
+	if (symbolIndexFind(symbolTable, identifier) != NULL)
 		return ERR_SEMANTICS_OTHER;
 
 	// Jedna se o novou promennou, je treba vypocitat offset
 	// -------------- Vypocet offsetu ----------------------------------------
-	offset = malloc(sizeof(int));
+	offset = compileArenaAlloc(sizeof(int));
 	if (offset == NULL)
 		return ERR_MEMORY;
 
 	// Vypocet offsetu parametru funkce = pocet polozek - zaznam volani funkce
 	*offset = symbolTable->itemCount - STACK_CALL_SPACE + 1;
-	error = insertItem(symbolTable, name, ITEM_VAR, offset);
+	error = symbolIndexInsert(symbolTable, name, ITEM_VAR, offset);
 	if (error)
-	{
-		free(offset);
 		return error;
-	}
 	return ERR_OK;
 }
 
@@ -1906,7 +2191,7 @@ ecode generateMainFunctionRecord()
 	}
 	functionRecord->varTabHead->itemCount = -1;
 	// -------------- Vlozeni do tabulky funkci-----------------------------------
-	error = insertItem(functionTable, name, ITEM_FUNCTION, functionRecord);
+	error = symbolIndexInsert(functionTable, name, ITEM_FUNCTION, functionRecord);
 	if (error)
 	{
 		freeTree(functionRecord->varTabHead);
@@ -1936,41 +2221,40 @@ ecode generateMainFunctionRecord()
 }
 
 /**
- * Funkce pro vygenerovani docasne promenne, necha si vygenerovat unikatni
- * retezec se jmenem promenne, vypocita jeji offset, vlozi ji do tabulky
- * symbolu a vrati vypocitany offset pro dalsi pouziti
- * Vygeneruje instrukci pro zkopirovani literalu na vypocitany offset na
- * zasobniku
+ * Funkce pro vygenerovani operandu literalu. Literaly (nil, logicka hodnota,
+ * cislo, retezec) se vlozi do tabulky konstant a misto offsetu se vrati
+ * operand konstanty, ktery instrukce ctou bez kopirovani
+ * Pro ostatni hodnoty (tRange) vytvori docasnou promennou a vygeneruje
+ * instrukci pro zkopirovani hodnoty na jeji offset na zasobniku
  * @param  instrList Seznam instrukci
  * @param  symTable  Tabulka symbolu
  * @param  type      Datovy typ promenne
  * @param  data      Hodnota promenne
- * @param  offset    Ukazatel pro ulozeni offsetu
+ * @param  offset    Ukazatel pro ulozeni offsetu nebo operandu konstanty
  * @return           ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
  */
 ecode generateAndInsertTemporaryVariable(tIList *instrList, tTableHead *symTable, SemanticType type, void *data, int **offset)
 {
 	ecode error;
-	String *tmpVarName;
 	int *tmpOffset;
 	tVariable *tmpVar;
+	tConstant *constant;
 
-	// -------------- Vytvoreni docasne promenne pro navratovou hodnotu ----------
-	tmpVarName = generateVariableName();
-
-	tmpOffset = malloc(sizeof(int));
-	if (tmpOffset == NULL)
-		return ERR_MEMORY;
+	// -------------- Literal se vlozi do tabulky konstant ----------------------
+	if (type != RANGE)
+	{
+		error = constantPoolInsert(type, data, &constant);
+		if (error)
+			return error;
 
-	*tmpOffset = symTable->itemCount + 1;
+		*offset = (int *) constant;
+		return ERR_OK;
+	}
 
-	// -------------- Vlozeni docasne promenne do TS -----------------------------
-	error = insertItem(symTable, tmpVarName, ITEM_VAR, tmpOffset);
+	// -------------- Vytvoreni docasne promenne ---------------------------------
+	error = generateTemporaryOffset(symTable, &tmpOffset);
 	if (error)
-	{
-		free(tmpOffset);
 		return error;
-	}
 
 	// -------------- Vytvoreni promenne s danym typem a hodnotou ----------------
 	error = createNewVariable(&tmpVar, type, data);
@@ -1978,7 +2262,7 @@ ecode generateAndInsertTemporaryVariable(tIList *instrList, tTableHead *symTable
 		return error;
 
 	// -------------- Vlozeni promenne na zasobnik -------------------------------
-	error = generateAndInsertInstruction(instructionList, INSTR_MOV, tmpOffset, tmpVar, NULL);
+	error = generateAndInsertInstruction(instrList, INSTR_MOV, tmpOffset, tmpVar, NULL);
 	if (error)
 		return error;
 
@@ -1987,6 +2271,29 @@ ecode generateAndInsertTemporaryVariable(tIList *instrList, tTableHead *symTable
 	return ERR_OK;
 }
 
+/**
+ * Funkce pro vytvoreni docasne promenne bez pocatecni hodnoty. Docasna
+ * promenna nema jmeno a do tabulky symbolu se nevklada, jen se pro ni
+ * zvysi pocet polozek tabulky (velikost ramce funkce)
+ * @param  symTable Tabulka symbolu
+ * @param  offset   Ukazatel pro ulozeni offsetu
+ * @return          ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode generateTemporaryOffset(tTableHead *symTable, int **offset)
+{
+	int *tmpOffset;
+
+	tmpOffset = compileArenaAlloc(sizeof(int));
+	if (tmpOffset == NULL)
+		return ERR_MEMORY;
+
+	// -------------- Rezervace mista v ramci funkce -----------------------------
+	*tmpOffset = ++symTable->itemCount;
+
+	*offset = tmpOffset;
+
+	return ERR_OK;
+}
 
 /**
  * Funkce pro vygenerovani instrukce a jeji vlozeni do seznamu instrukci
@@ -2007,73 +2314,98 @@ ecode generateAndInsertInstruction(tIList *list, InstructionType type, void *tar
 		return ERR_MEMORY;
 
 	// -------------- Instrukce se vlozi do seznamu instrukci --------------------
+	// -------------- (instrukce je v arene prekladu, neuvolnuje se) -----------
 	error = tIListInsertLast(list, instruction);
 	if (error)
-	{
-		free(instruction);
 		return error;
-	}
 
 	return ERR_OK;
 }
 
 
 /**
- * Funkce pro generovani jmena pomocne promenne prekladace ve tvaru:
- * $T<cislo>
- * Cislo je ulozeno v globalni promenne internalVariableCount
- * @return Retezec se jmenem nebo NULL pri chybe
+ * Inicializace kontextu prekladu tela funkce nebo hlavniho tela
+ * @param  context      Inicializovany kontext
+ * @param  function     Zaznam prekladane funkce
+ * @param  instructions Seznam, do ktereho se generuji instrukce tela
+ * @return              ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
  */
-String *generateVariableName()
+static ecode compileContextInit(tCompileContext *context, tFunctionData *function, tIList *instructions)
 {
-	String *newName;
-	String *suffix;
+	context->function = function;
+	context->instructions = instructions;
+	context->savedVariableCount = 0;
+	tLabelTableInit(&context->labels);
 
-	newName = charToString("$T");
-	if (newName == NULL)
-		return NULL;
+	context->labelStack = tLabelStackInit();
+	if (context->labelStack == NULL)
+	{
+		tLabelTableFree(&context->labels);
+		return ERR_MEMORY;
+	}
+	return ERR_OK;
+}
 
-	suffix = numberToString(internalVariableCount);
-	if (suffix == NULL)
-		return NULL;
+/**
+ * Uvolneni navesti kontextu, instrukce zustavaji v seznamu kontextu
+ * @param context Uvolnovany kontext
+ */
+static void compileContextFree(tCompileContext *context)
+{
+	tLabelStackFree(context->labelStack);
+	context->labelStack = NULL;
+	tLabelTableFree(&context->labels);
+}
 
-	newName = stringConcatenate(newName, suffix);
-	if (newName == NULL)
-		return NULL;
+/**
+ * Vytvoreni navesti v tabulce navesti prekladaneho tela a jeho vlozeni
+ * na zasobnik navesti. Instrukci navesti doplni resolveLabel
+ * @param  context Kontext prekladu
+ * @param  label   Ukazatel pro ulozeni cisla navesti
+ * @return         ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode generateLabel(tCompileContext *context, int *label)
+{
+	ecode error;
+
+	error = tLabelTableNew(&context->labels, label);
+	if (error)
+		return error;
 
-	deallocString(suffix);
-	internalVariableCount++;
-	return newName;
+	return tLabelStackPush(context->labelStack, *label);
 }
 
 /**
- * Funkce pro generovani unikatniho jmena navesti ve tvaru:
- * $L<cislo>
- * @return Retezec se jmenem nebo NULL pri chybe
+ * Nastaveni navesti na vrcholu zasobniku navesti na posledni vygenerovanou
+ * instrukci a jeho odstraneni ze zasobniku
+ * @param context Kontext prekladu
  */
-String *generateLabelName()
+void resolveLabel(tCompileContext *context)
 {
-	String *newName;
-	String *suffix;
-	static int labelCount = 0;
-	newName = charToString("$L");
-	if (newName == NULL)
-		return NULL;
+	tLabelTableSet(&context->labels, tLabelStackTop(context->labelStack), tIListGetLast(context->instructions));
+	tLabelStackPop(context->labelStack);
+}
 
-	suffix = numberToString(labelCount);
-	if (suffix == NULL)
-		return NULL;
+/**
+ * Generovani instrukce skoku na navesti prekladaneho tela, cilova instrukce
+ * se do skoku doplni po prekladu tela
+ * @param  context   Kontext prekladu
+ * @param  type      INSTR_GOTO nebo INSTR_IFGOTO
+ * @param  label     Cislo ciloveho navesti
+ * @param  condition Offset podminky pro INSTR_IFGOTO, jinak NULL
+ * @return           ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode generateJump(tCompileContext *context, InstructionType type, int label, void *condition)
+{
+	ecode error;
 
-	newName = stringConcatenate(newName, suffix);
-	if (newName == NULL)
-		return NULL;
+	error = generateAndInsertInstruction(context->instructions, type, NULL, condition, NULL);
+	if (error)
+		return error;
 
-	deallocString(suffix);
-	labelCount++;
-	return newName;
+	return tLabelTableAddJump(&context->labels, tIListGetLast(context->instructions)->instruction, label);
 }
 
-
 /**
  * Funkce, ktera z typu tokenu urci semanticky typ promenne a ten vrati
  * @param  type Typ tokenu
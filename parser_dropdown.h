@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include "errnum.h"
+#include "ilist.h"
 /**
  * Provede syntaktickou analyzu zdrojoveho souboru metodou rekurzivniho sestupu,
  * pro syntaktickou analyzu vyrazu vola prislusnou funkci precedencni syntakticke
@@ -25,4 +26,49 @@
  */
 ecode parseFile(FILE *f);
 
+/**
+ * Preklad zdrojoveho souboru s cache prelozeneho programu. Pokud soubor cache
+ * odpovida zdrojovemu kodu, program se nacte z nej bez prekladu, jinak se
+ * zdroj prelozi funkci parseFile a prelozeny program se do cache zapise.
+ * Pri prekladu s PARSER_LAZY_FUNCTIONS se cache nepouziva
+ * @param  f         Zdrojovy soubor
+ * @param  cachePath Cesta k souboru cache
+ * @return           ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode parseFileCached(FILE *f, const char *cachePath);
+
+/**
+ * Preklad programu ze zdrojoveho kodu v pameti, napr. pri vlozeni interpretu
+ * do jine aplikace. Buffer se nekopiruje a nemusi byt ukoncen nulou, musi ale
+ * zustat platny po dobu prekladu (s PARSER_LAZY_FUNCTIONS az do uvolneni
+ * programu funkci tIListFree)
+ *
+ * Stejne jako parseFile preklada do globalnich struktur (instructionList,
+ * functionTable a tabulka konstant), samostatny program nevraci. Prelozeny
+ * program se spousti funkci interpreter(instructionList). V kazdem okamziku
+ * muze byt prelozen jen jeden program, pred dalsim volanim (i po neuspesnem
+ * prekladu) musi volajici program uvolnit:
+ *   1. tIListFree(instructionList) - instrukce, konstanty a stav prekladu
+ *   2. uvolnit zaznamy funkci v functionTable a nahradit ji prazdnou
+ *      tabulkou (initTable)
+ * Pokud predchozi program uvolnen neni, funkce nic nezmeni a vrati
+ * ERR_INTERNAL
+ * @param  src    Zdrojovy kod
+ * @param  length Delka zdrojoveho kodu
+ * @return        ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode parseBuffer(const char *src, size_t length);
+
+#ifdef PARSER_LAZY_FUNCTIONS
+#include "global.h"
+/**
+ * Preklad tela funkce pri jejim prvnim volani. Pri prekladu s definovanym
+ * PARSER_LAZY_FUNCTIONS druhy pruchod definice funkci preskakuje a syntakticke
+ * i semanticke chyby v tele funkce se zjisti az pri jejim prvnim volani
+ * @param  functionRecord Zaznam volane funkce
+ * @return                ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode parseFunction(tFunctionData *functionRecord);
+#endif
+
 #endif // PARSER_H
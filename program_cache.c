@@ -0,0 +1,1043 @@
+// program_cache.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Cache file with the compiled program, keyed by a hash of the source        *
+ ******************************************************************************
+ */
+
+#include "program_cache.h"
+#include "compile_arena.h"
+#include "constant_pool.h"
+#include "global.h"
+#include "ial.h"
+#include "ilist.h"
+#include "libstring.h"
+#include "string_ops.h"
+#include "symbol_index.h"
+#include "variable.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PROGRAM_CACHE_MAGIC "IFJ12PC"
+#define PROGRAM_CACHE_BYTE_ORDER 0x01020304u
+
+// Identifikator sestaveni, build system ho muze nahradit napr. hashem revize
+#ifndef PROGRAM_CACHE_BUILD_ID
+#define PROGRAM_CACHE_BUILD_ID __DATE__ " " __TIME__
+#endif
+
+// Rostouci buffer jedne sekce souboru
+typedef struct
+{
+	char *data;
+	size_t length;
+	size_t size;
+} tCacheBuffer;
+
+// Prirazeni indexu ukazatelum (instrukce a zaznamy funkci) pri zapisu
+typedef struct
+{
+	const void **keys;
+	int *values;
+	int size;		// Velikost tabulky (mocnina dvou)
+} tPointerMap;
+
+// Sekce nacteneho souboru
+typedef struct
+{
+	const tCacheHeader *header;
+	const tCacheFunction *functions;
+	const tCacheConstant *constants;
+	const tCacheInstruction *instructions;
+	const tCacheOperand *operands;
+	const char *strings;
+} tCacheSections;
+
+// Klic cache
+uint64_t programCacheKey(const char *data, size_t length)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= (unsigned char) data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// Otisk sestaveni interpretu
+uint64_t programCacheBuildId()
+{
+	// Hodnoty vyctu v poradi deklarace, zmena poradi zmeni otisk
+	static const int64_t layout[] = {
+		INSTR_GOTO, INSTR_IFGOTO, INSTR_CALL, INSTR_RET, INSTR_HALT, INSTR_LABEL,
+		INSTR_ADD, INSTR_SUBTRACT, INSTR_MULTIPLY, INSTR_DIVIDE, INSTR_POWER,
+		INSTR_LESSER, INSTR_GREATER, INSTR_EQUAL, INSTR_LESSER_OR_EQUAL,
+		INSTR_GREATER_OR_EQUAL, INSTR_NOT_EQUAL, INSTR_SUBSTRING, INSTR_PUSH,
+		INSTR_PUSH_STACK, INSTR_POP, INSTR_INPUT, INSTR_NUMERIC, INSTR_PRINT,
+		INSTR_TYPEOF, INSTR_LEN, INSTR_FIND, INSTR_SORT, INSTR_MOV,
+		INSTR_MOV_STACK, INSTR_REMOVE_STACK,
+		OPERAND_NONE, OPERAND_OFFSET, OPERAND_CONSTANT, OPERAND_IMMEDIATE, OPERAND_POINTER,
+		NIL, LOGICAL, NUMERIC, STRING, FUNCTION,
+		sizeof(InstructionType), sizeof(tInstruction), sizeof(tOperand), sizeof(tListOperand),
+		sizeof(tVariable), sizeof(tRange), sizeof(tConstant), CONSTANT_OPERAND_OFFSET,
+		sizeof(tCacheHeader), sizeof(tCacheFunction), sizeof(tCacheConstant),
+		sizeof(tCacheInstruction), sizeof(tCacheOperand)
+	};
+	static const char buildId[] = PROGRAM_CACHE_BUILD_ID;
+
+	return programCacheKey(buildId, sizeof(buildId) - 1) ^
+	       programCacheKey((const char *) layout, sizeof(layout)) * 31;
+}
+
+// -------------- Zapis --------------------------------------------------------
+
+/**
+ * Pridani dat na konec bufferu
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode bufferAppend(tCacheBuffer *buffer, const void *data, size_t length)
+{
+	char *newData;
+	size_t newSize;
+
+	if (buffer->length + length > buffer->size)
+	{
+		newSize = buffer->size == 0 ? 4096 : buffer->size;
+		while (newSize < buffer->length + length)
+			newSize *= 2;
+
+		newData = realloc(buffer->data, newSize);
+		if (newData == NULL)
+			return ERR_MEMORY;
+		buffer->data = newData;
+		buffer->size = newSize;
+	}
+
+	memcpy(buffer->data + buffer->length, data, length);
+	buffer->length += length;
+	return ERR_OK;
+}
+
+/**
+ * Pozice ukazatele v tabulce, pri neuspechu volna pozice
+ */
+static int pointerMapSlot(tPointerMap *map, const void *key)
+{
+	int slot = (int) ((uintptr_t) key >> 4) * 2654435761u & (map->size - 1);
+
+	while (map->keys[slot] != NULL && map->keys[slot] != key)
+		slot = (slot + 1) & (map->size - 1);
+
+	return slot;
+}
+
+/**
+ * Vytvoreni tabulky pro dany pocet ukazatelu
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode pointerMapInit(tPointerMap *map, int count)
+{
+	map->size = 16;
+	while (map->size < 2 * count)
+		map->size *= 2;
+
+	map->keys = calloc(map->size, sizeof(void *));
+	map->values = malloc(map->size * sizeof(int));
+	return map->keys != NULL && map->values != NULL ? ERR_OK : ERR_MEMORY;
+}
+
+static void pointerMapPut(tPointerMap *map, const void *key, int value)
+{
+	int slot = pointerMapSlot(map, key);
+	map->keys[slot] = key;
+	map->values[slot] = value;
+}
+
+static int pointerMapGet(tPointerMap *map, const void *key)
+{
+	int slot = pointerMapSlot(map, key);
+	return map->keys[slot] != NULL ? map->values[slot] : -1;
+}
+
+/**
+ * Hodnota operandu, ktery neni ukazatel
+ */
+static int32_t operandValue(unsigned char kind, tOperand operand)
+{
+	switch (kind)
+	{
+		case OPERAND_OFFSET:
+			return operand.offset;
+		case OPERAND_CONSTANT:
+			return operand.constant;
+		case OPERAND_IMMEDIATE:
+			return operand.immediate;
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Zapis seznamu operandu instrukce PRINT nebo FIND
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode saveOperandArray(tCacheBuffer *operands, tOperandArray *array, int32_t *index)
+{
+	tCacheOperand record = { OPERAND_NONE, array->count };
+
+	*index = operands->length / sizeof(tCacheOperand);
+	if (bufferAppend(operands, &record, sizeof(record)) != ERR_OK)
+		return ERR_MEMORY;
+
+	for (int i = 0; i < array->count; i++)
+	{
+		record.kind = array->operands[i].kind;
+		record.value = operandValue(array->operands[i].kind, array->operands[i].operand);
+		if (bufferAppend(operands, &record, sizeof(record)) != ERR_OK)
+			return ERR_MEMORY;
+	}
+	return ERR_OK;
+}
+
+/**
+ * Zapis mezi rozsahu instrukce MOV (int * offsetu, tConstant * nebo NULL)
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode saveRangeBound(tCacheBuffer *operands, void *bound)
+{
+	tCacheOperand record = { OPERAND_NONE, 0 };
+
+	if (bound != NULL && isConstantOperand(bound))
+	{
+		record.kind = OPERAND_CONSTANT;
+		record.value = ((tConstant *) bound)->index;
+	}
+	else if (bound != NULL)
+	{
+		record.kind = OPERAND_OFFSET;
+		record.value = *((int *) bound);
+	}
+
+	return bufferAppend(operands, &record, sizeof(record));
+}
+
+/**
+ * Prevod ukazatele v operandu instrukce na index
+ * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode savePointer(tInstruction *instruction, int operand, tPointerMap *items, tPointerMap *functions,
+                         tCacheBuffer *operands, int32_t *value)
+{
+	tRange *range;
+
+	switch (instruction->instruction)
+	{
+		case INSTR_GOTO:
+		case INSTR_IFGOTO:
+			if (operand != 1)
+				return ERR_INTERNAL;
+			*value = pointerMapGet(items, instruction->op1.pointer);
+			return *value >= 0 ? ERR_OK : ERR_INTERNAL;
+
+		case INSTR_CALL:
+			if (operand != 1)
+				return ERR_INTERNAL;
+			*value = pointerMapGet(functions, instruction->op1.pointer);
+			return *value >= 0 ? ERR_OK : ERR_INTERNAL;
+
+		case INSTR_PRINT:
+		case INSTR_FIND:
+			// Tabulka posunu FIND se pri nacteni vytvori z konstanty
+			if (operand == 3 && instruction->instruction == INSTR_FIND)
+			{
+				*value = 0;
+				return ERR_OK;
+			}
+			if (operand != 2)
+				return ERR_INTERNAL;
+			return saveOperandArray(operands, instruction->op2.pointer, value);
+
+		case INSTR_MOV:
+			if (operand != 2 || ((tVariable *) instruction->op2.pointer)->semantic != RANGE)
+				return ERR_INTERNAL;
+			range = ((tVariable *) instruction->op2.pointer)->value;
+			*value = operands->length / sizeof(tCacheOperand);
+			if (saveRangeBound(operands, range->off1) != ERR_OK || saveRangeBound(operands, range->off2) != ERR_OK)
+				return ERR_MEMORY;
+			return ERR_OK;
+
+		default:
+			return ERR_INTERNAL;
+	}
+}
+
+/**
+ * Zapis operandu instrukce
+ * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode saveOperand(tInstruction *instruction, int operand, tPointerMap *items, tPointerMap *functions,
+                         tCacheBuffer *operands, int32_t *value)
+{
+	unsigned char kind = operand == 1 ? instruction->kind1 : operand == 2 ? instruction->kind2 : instruction->kind3;
+	tOperand op = operand == 1 ? instruction->op1 : operand == 2 ? instruction->op2 : instruction->op3;
+
+	if (kind == OPERAND_POINTER)
+		return savePointer(instruction, operand, items, functions, operands, value);
+
+	*value = operandValue(kind, op);
+	return ERR_OK;
+}
+
+/**
+ * Zapis retezce do sekce retezcu
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode saveString(tCacheBuffer *strings, String *string, uint32_t *offset, uint32_t *length)
+{
+	*offset = strings->length;
+	*length = string->length;
+	return bufferAppend(strings, string->data, string->length);
+}
+
+/**
+ * Sestaveni vsech sekci souboru z prelozeneho programu
+ * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode saveSections(tCacheHeader *header, tCacheBuffer *sections, tPointerMap *items, tPointerMap *functions)
+{
+	tCacheBuffer *functionSection = &sections[0];
+	tCacheBuffer *constantSection = &sections[1];
+	tCacheBuffer *instructionSection = &sections[2];
+	tCacheBuffer *operandSection = &sections[3];
+	tCacheBuffer *stringSection = &sections[4];
+	tSymbolIndexEntry *entry;
+	tFunctionData *data;
+	tIListItem *item;
+	tVariable *value;
+	int index;
+
+	// -------------- Indexy instrukci -------------------------------------------
+	index = 0;
+	for (item = instructionList->first; item != NULL; item = item->nextItem)
+		pointerMapPut(items, item, index++);
+	header->instructionCount = index;
+
+	// -------------- Funkce programu (vestavene funkce se neukladaji) -----------
+	for (int i = 0; i < symbolIndex.size; i++)
+	{
+		entry = &symbolIndex.entries[i];
+		if (entry->table != functionTable || entry->name->function != FUNCTION_OTHER)
+			continue;
+
+		data = entry->item->data;
+		if (data->firstInstruction == NULL)
+			return ERR_INTERNAL;
+
+		tCacheFunction record = {
+			0, 0, data->paramsCount, data->varTabHead->itemCount,
+			pointerMapGet(items, data->firstInstruction),
+			data->lastInstruction != NULL ? pointerMapGet(items, data->lastInstruction) : -1
+		};
+		if (saveString(stringSection, (String *) &entry->name->key, &record.nameOffset, &record.nameLength) != ERR_OK ||
+		    bufferAppend(functionSection, &record, sizeof(record)) != ERR_OK)
+			return ERR_MEMORY;
+
+		pointerMapPut(functions, data, header->functionCount++);
+	}
+
+	// -------------- Tabulka konstant -------------------------------------------
+	for (int i = 0; i < constantPool.count; i++)
+	{
+		value = constantPoolValue(i);
+		tCacheConstant record = { value->semantic, 0, 0, 0, 0.0 };
+
+		if (value->semantic == STRING && saveString(stringSection, value->value, &record.stringOffset, &record.stringLength) != ERR_OK)
+			return ERR_MEMORY;
+		else if (value->semantic == NUMERIC)
+			record.number = *((double *) value->value);
+		else if (value->semantic == LOGICAL)
+			record.logical = *((bool *) value->value);
+
+		if (bufferAppend(constantSection, &record, sizeof(record)) != ERR_OK)
+			return ERR_MEMORY;
+	}
+	header->constantCount = constantPool.count;
+
+	// -------------- Instrukce --------------------------------------------------
+	for (item = instructionList->first; item != NULL; item = item->nextItem)
+	{
+		ecode error;
+		tInstruction *instruction = item->instruction;
+		tCacheInstruction record = {
+			instruction->instruction, instruction->kind1, instruction->kind2, instruction->kind3,
+			0, item->lineNumber, 0, 0, 0
+		};
+
+		if ((error = saveOperand(instruction, 1, items, functions, operandSection, &record.op1)) ||
+		    (error = saveOperand(instruction, 2, items, functions, operandSection, &record.op2)) ||
+		    (error = saveOperand(instruction, 3, items, functions, operandSection, &record.op3)))
+			return error;
+
+		if (bufferAppend(instructionSection, &record, sizeof(record)) != ERR_OK)
+			return ERR_MEMORY;
+	}
+
+	header->operandCount = operandSection->length / sizeof(tCacheOperand);
+	header->stringSize = stringSection->length;
+
+	// Sekce za retezci musi zustat zarovnane, retezce jsou posledni
+	return ERR_OK;
+}
+
+// Zapis prelozeneho programu
+ecode programCacheSave(const char *path, uint64_t key)
+{
+	ecode error;
+	tCacheHeader header;
+	tCacheBuffer sections[5];
+	tPointerMap items = { NULL, NULL, 0 }, functions = { NULL, NULL, 0 };
+	char *tmpPath;
+	FILE *file;
+	int count = 0;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PROGRAM_CACHE_MAGIC, sizeof(header.magic));
+	header.version = PROGRAM_CACHE_VERSION;
+	header.byteOrder = PROGRAM_CACHE_BYTE_ORDER;
+	header.key = key;
+	header.build = programCacheBuildId();
+	memset(sections, 0, sizeof(sections));
+
+	for (tIListItem *item = instructionList->first; item != NULL; item = item->nextItem)
+		count++;
+
+	error = pointerMapInit(&items, count);
+	if (error == ERR_OK)
+		error = pointerMapInit(&functions, symbolIndex.count);
+	if (error == ERR_OK)
+		error = saveSections(&header, sections, &items, &functions);
+
+	// -------------- Zapis pod docasnym jmenem a prejmenovani -------------------
+	tmpPath = error == ERR_OK ? malloc(strlen(path) + 5) : NULL;
+	if (error == ERR_OK && tmpPath == NULL)
+		error = ERR_MEMORY;
+	if (error == ERR_OK)
+	{
+		sprintf(tmpPath, "%s.tmp", path);
+		file = fopen(tmpPath, "wb");
+		if (file == NULL)
+			error = ERR_INTERNAL;
+		else
+		{
+			if (fwrite(&header, sizeof(header), 1, file) != 1)
+				error = ERR_INTERNAL;
+			for (int i = 0; i < 5 && error == ERR_OK; i++)
+			{
+				if (sections[i].length > 0 && fwrite(sections[i].data, sections[i].length, 1, file) != 1)
+					error = ERR_INTERNAL;
+			}
+			if (fclose(file) != 0)
+				error = ERR_INTERNAL;
+
+			if (error == ERR_OK && rename(tmpPath, path) != 0)
+				error = ERR_INTERNAL;
+			if (error != ERR_OK)
+				remove(tmpPath);
+		}
+	}
+
+	free(tmpPath);
+	for (int i = 0; i < 5; i++)
+		free(sections[i].data);
+	free(items.keys);
+	free(items.values);
+	free(functions.keys);
+	free(functions.values);
+	return error;
+}
+
+// -------------- Nacteni ------------------------------------------------------
+
+/**
+ * Kontrola operandu, ktery neni ukazatel
+ */
+static bool validOperand(const tCacheSections *cache, uint32_t kind, int32_t value)
+{
+	switch (kind)
+	{
+		case OPERAND_NONE:
+		case OPERAND_OFFSET:
+		case OPERAND_IMMEDIATE:
+			return true;
+		case OPERAND_CONSTANT:
+			return value >= 0 && (uint32_t) value < cache->header->constantCount;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Kontrola seznamu operandu instrukce PRINT nebo FIND
+ */
+static bool validOperandArray(const tCacheSections *cache, int32_t index)
+{
+	const tCacheHeader *header = cache->header;
+	const tCacheOperand *list;
+
+	if (index < 0 || (uint32_t) index >= header->operandCount)
+		return false;
+
+	list = &cache->operands[index];
+	if (list->kind != OPERAND_NONE || list->value < 0 || (uint32_t) list->value > header->operandCount - index - 1)
+		return false;
+
+	for (int i = 1; i <= list->value; i++)
+	{
+		if ((list[i].kind != OPERAND_OFFSET && list[i].kind != OPERAND_CONSTANT) ||
+		    !validOperand(cache, list[i].kind, list[i].value))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Kontrola ukazatele ulozeneho jako index
+ */
+static bool validPointer(const tCacheSections *cache, const tCacheInstruction *record, int operand, int32_t value)
+{
+	const tCacheHeader *header = cache->header;
+	const tCacheOperand *list;
+
+	switch (record->instruction)
+	{
+		case INSTR_GOTO:
+		case INSTR_IFGOTO:
+			return operand == 1 && value >= 0 && (uint32_t) value < header->instructionCount;
+
+		case INSTR_CALL:
+			return operand == 1 && value >= 0 && (uint32_t) value < header->functionCount;
+
+		case INSTR_PRINT:
+			return operand == 2 && validOperandArray(cache, value);
+
+		case INSTR_FIND:
+			if (operand == 2)
+				return validOperandArray(cache, value);
+			// Tabulka posunu se vytvori z konstantniho retezce, druheho parametru
+			if (operand != 3 || record->kind2 != OPERAND_POINTER || !validOperandArray(cache, record->op2))
+				return false;
+			list = &cache->operands[record->op2];
+			return list->value >= 2 && list[2].kind == OPERAND_CONSTANT &&
+			       cache->constants[list[2].value].type == STRING;
+
+		case INSTR_MOV:
+			return operand == 2 && value >= 0 && (uint32_t) value + 2 <= header->operandCount &&
+			       (cache->operands[value].kind == OPERAND_NONE || validOperand(cache, cache->operands[value].kind, cache->operands[value].value)) &&
+			       (cache->operands[value + 1].kind == OPERAND_NONE || validOperand(cache, cache->operands[value + 1].kind, cache->operands[value + 1].value)) &&
+			       cache->operands[value].kind != OPERAND_IMMEDIATE && cache->operands[value + 1].kind != OPERAND_IMMEDIATE;
+
+		default:
+			return false;
+	}
+}
+
+/**
+ * Hash jmena funkce nebo hodnoty konstanty (FNV-1a)
+ * @param  constants true pro zaznam konstanty, false pro zaznam funkce
+ * @param  index     Index zaznamu
+ * @return           Hash zaznamu
+ */
+static uint32_t recordHash(const tCacheSections *cache, bool constants, uint32_t index)
+{
+	uint32_t hash = 2166136261u;
+	const unsigned char *bytes;
+	uint32_t length;
+
+	if (constants)
+	{
+		const tCacheConstant *constant = &cache->constants[index];
+		hash ^= constant->type;
+		if (constant->type == STRING)
+		{
+			bytes = (const unsigned char *) cache->strings + constant->stringOffset;
+			length = constant->stringLength;
+		}
+		else if (constant->type == NUMERIC)
+		{
+			bytes = (const unsigned char *) &constant->number;
+			length = sizeof(double);
+		}
+		else
+			return hash ^ (constant->type == LOGICAL && constant->logical != 0);
+	}
+	else
+	{
+		bytes = (const unsigned char *) cache->strings + cache->functions[index].nameOffset;
+		length = cache->functions[index].nameLength;
+	}
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Porovnani dvou zaznamu stejne jako pri vkladani do tabulky konstant
+ * (constantPoolInsert) nebo do tabulky funkci
+ * @return true pokud by se zaznamy v tabulce strefily do stejne polozky
+ */
+static bool recordEquals(const tCacheSections *cache, bool constants, uint32_t first, uint32_t second)
+{
+	if (!constants)
+	{
+		const tCacheFunction *a = &cache->functions[first], *b = &cache->functions[second];
+		return a->nameLength == b->nameLength &&
+		       memcmp(cache->strings + a->nameOffset, cache->strings + b->nameOffset, a->nameLength) == 0;
+	}
+
+	const tCacheConstant *a = &cache->constants[first], *b = &cache->constants[second];
+	if (a->type != b->type)
+		return false;
+
+	switch (a->type)
+	{
+		case STRING:
+			return a->stringLength == b->stringLength &&
+			       memcmp(cache->strings + a->stringOffset, cache->strings + b->stringOffset, a->stringLength) == 0;
+		case NUMERIC:
+			return memcmp(&a->number, &b->number, sizeof(double)) == 0;
+		case LOGICAL:
+			return (a->logical != 0) == (b->logical != 0);
+		default:	// NIL, FUNCTION
+			return true;
+	}
+}
+
+/**
+ * Kontrola, ze se zadna konstanta ani jmeno funkce neopakuje. Opakovany
+ * zaznam by se pri nacitani odmitl az po zmene tabulky konstant nebo funkci
+ * @param  constants true pro konstanty, false pro funkce
+ * @param  count     Pocet zaznamu
+ * @return           true pokud jsou vsechny zaznamy ruzne
+ */
+static bool uniqueRecords(const tCacheSections *cache, bool constants, uint32_t count)
+{
+	uint32_t size = 16, slot;
+	int64_t *table;
+	bool unique = true;
+
+	while (size < 2 * (uint64_t) count)
+		size *= 2;
+
+	table = malloc(size * sizeof(int64_t));
+	if (table == NULL)
+		return false;
+	for (uint32_t i = 0; i < size; i++)
+		table[i] = -1;
+
+	for (uint32_t i = 0; i < count && unique; i++)
+	{
+		slot = recordHash(cache, constants, i) & (size - 1);
+		while (table[slot] != -1 && (unique = !recordEquals(cache, constants, table[slot], i)))
+			slot = (slot + 1) & (size - 1);
+		table[slot] = i;
+	}
+
+	free(table);
+	return unique;
+}
+
+/**
+ * Kontrola celeho souboru pred zmenou programu
+ * @return true pokud soubor odpovida klici a vsechny indexy jsou platne
+ */
+static bool validateCache(const char *data, size_t size, uint64_t key, tCacheSections *cache)
+{
+	const tCacheHeader *header = (const tCacheHeader *) data;
+	size_t offset = sizeof(tCacheHeader);
+
+	if (size < sizeof(tCacheHeader) || memcmp(header->magic, PROGRAM_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+	    header->version != PROGRAM_CACHE_VERSION || header->byteOrder != PROGRAM_CACHE_BYTE_ORDER || header->key != key ||
+	    header->build != programCacheBuildId())
+		return false;
+
+	// -------------- Sekce musi presne vyplnit soubor ---------------------------
+	if ((uint64_t) header->functionCount * sizeof(tCacheFunction) + (uint64_t) header->constantCount * sizeof(tCacheConstant) +
+	    (uint64_t) header->instructionCount * sizeof(tCacheInstruction) + (uint64_t) header->operandCount * sizeof(tCacheOperand) +
+	    header->stringSize != size - offset)
+		return false;
+
+	cache->header = header;
+	cache->functions = (const tCacheFunction *) (data + offset);
+	offset += header->functionCount * sizeof(tCacheFunction);
+	cache->constants = (const tCacheConstant *) (data + offset);
+	offset += header->constantCount * sizeof(tCacheConstant);
+	cache->instructions = (const tCacheInstruction *) (data + offset);
+	offset += header->instructionCount * sizeof(tCacheInstruction);
+	cache->operands = (const tCacheOperand *) (data + offset);
+	offset += header->operandCount * sizeof(tCacheOperand);
+	cache->strings = data + offset;
+
+	for (uint32_t i = 0; i < header->functionCount; i++)
+	{
+		const tCacheFunction *function = &cache->functions[i];
+		if ((uint64_t) function->nameOffset + function->nameLength > header->stringSize ||
+		    function->firstInstruction < 0 || (uint32_t) function->firstInstruction >= header->instructionCount ||
+		    function->lastInstruction < -1 || function->lastInstruction >= (int32_t) header->instructionCount)
+			return false;
+	}
+
+	for (uint32_t i = 0; i < header->constantCount; i++)
+	{
+		const tCacheConstant *constant = &cache->constants[i];
+		if ((constant->type != NIL && constant->type != LOGICAL && constant->type != NUMERIC &&
+		     constant->type != STRING && constant->type != FUNCTION) ||
+		    (uint64_t) constant->stringOffset + constant->stringLength > header->stringSize)
+			return false;
+	}
+
+	for (uint32_t i = 0; i < header->instructionCount; i++)
+	{
+		const tCacheInstruction *record = &cache->instructions[i];
+		const uint8_t kinds[3] = { record->kind1, record->kind2, record->kind3 };
+		const int32_t values[3] = { record->op1, record->op2, record->op3 };
+
+		if (record->instruction > INSTR_REMOVE_STACK)
+			return false;
+
+		for (int k = 0; k < 3; k++)
+		{
+			if (kinds[k] == OPERAND_POINTER ? !validPointer(cache, record, k + 1, values[k])
+			                                : !validOperand(cache, kinds[k], values[k]))
+				return false;
+		}
+	}
+
+	// -------------- Opakovane zaznamy by selhaly az pri nacitani ---------------
+	return uniqueRecords(cache, true, header->constantCount) && uniqueRecords(cache, false, header->functionCount);
+}
+
+/**
+ * Vytvoreni retezce ze sekce retezcu
+ * @return Retezec nebo NULL pri nedostatku pameti
+ */
+static String *loadString(const tCacheSections *cache, uint32_t offset, uint32_t length)
+{
+	String *string;
+	char *buffer;
+
+	// Retezec s nulovym znakem nelze vytvorit funkci charToString
+	if (memchr(cache->strings + offset, '\0', length) != NULL)
+	{
+		string = charToString("");
+		for (uint32_t i = 0; i < length && string != NULL; i++)
+			string = addCharToString(string, cache->strings[offset + i]);
+		return string;
+	}
+
+	buffer = malloc(length + 1);
+	if (buffer == NULL)
+		return NULL;
+	memcpy(buffer, cache->strings + offset, length);
+	buffer[length] = '\0';
+	string = charToString(buffer);
+	free(buffer);
+	return string;
+}
+
+/**
+ * Vlozeni konstant do tabulky konstant se stejnymi indexy
+ * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode loadConstants(const tCacheSections *cache)
+{
+	ecode error;
+	tConstant *constant;
+	void *data;
+
+	for (uint32_t i = 0; i < cache->header->constantCount; i++)
+	{
+		const tCacheConstant *record = &cache->constants[i];
+		data = NULL;
+
+		if (record->type == STRING)
+			data = loadString(cache, record->stringOffset, record->stringLength);
+		else if (record->type == NUMERIC && (data = malloc(sizeof(double))) != NULL)
+			*((double *) data) = record->number;
+		else if (record->type == LOGICAL && (data = malloc(sizeof(bool))) != NULL)
+			*((bool *) data) = record->logical != 0;
+
+		if (data == NULL && (record->type == STRING || record->type == NUMERIC || record->type == LOGICAL))
+			return ERR_MEMORY;
+
+		error = constantPoolInsert(record->type, data, &constant);
+		if (error)
+			return error;
+		if ((uint32_t) constant->index != i)
+			return ERR_INTERNAL;
+	}
+	return ERR_OK;
+}
+
+/**
+ * Vytvoreni zaznamu funkci a jejich vlozeni do tabulky funkci
+ * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode loadFunctions(const tCacheSections *cache, tFunctionData **functions)
+{
+	ecode error;
+	String *name;
+
+	for (uint32_t i = 0; i < cache->header->functionCount; i++)
+	{
+		const tCacheFunction *record = &cache->functions[i];
+
+		functions[i] = calloc(1, sizeof(tFunctionData));
+		if (functions[i] == NULL)
+			return ERR_MEMORY;
+		functions[i]->paramsCount = record->paramsCount;
+		functions[i]->varTabHead = initTable();
+		if (functions[i]->varTabHead == NULL)
+			return ERR_MEMORY;
+		functions[i]->varTabHead->itemCount = record->frameSize;
+
+		name = loadString(cache, record->nameOffset, record->nameLength);
+		if (name == NULL)
+			return ERR_MEMORY;
+		error = insertItem(functionTable, name, ITEM_FUNCTION, functions[i]);
+		if (error)
+			return error;
+	}
+	return ERR_OK;
+}
+
+/**
+ * Nastaveni operandu instrukce, ktery neni ukazatel
+ */
+static tOperand loadOperand(uint32_t kind, int32_t value)
+{
+	tOperand operand;
+
+	operand.pointer = NULL;
+	if (kind == OPERAND_OFFSET)
+		operand.offset = value;
+	else if (kind == OPERAND_CONSTANT)
+		operand.constant = value;
+	else if (kind == OPERAND_IMMEDIATE)
+		operand.immediate = value;
+	return operand;
+}
+
+/**
+ * Vytvoreni pole operandu instrukce PRINT nebo FIND v arene prekladu
+ */
+static tOperandArray *loadOperandArray(const tCacheSections *cache, int32_t index)
+{
+	const tCacheOperand *list = &cache->operands[index];
+	tOperandArray *array = compileArenaAlloc(sizeof(tOperandArray) + list->value * sizeof(tListOperand));
+
+	if (array == NULL)
+		return NULL;
+
+	array->count = list->value;
+	for (int i = 0; i < list->value; i++)
+	{
+		array->operands[i].kind = list[i + 1].kind;
+		array->operands[i].operand = loadOperand(list[i + 1].kind, list[i + 1].value);
+	}
+	return array;
+}
+
+/**
+ * Vytvoreni meze rozsahu (int * offsetu v arene, tConstant * nebo NULL)
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode loadRangeBound(const tCacheOperand *record, int **bound)
+{
+	*bound = NULL;
+	if (record->kind == OPERAND_CONSTANT)
+		*bound = (int *) constantPool.constants[record->value];
+	else if (record->kind == OPERAND_OFFSET)
+	{
+		*bound = compileArenaAlloc(sizeof(int));
+		if (*bound == NULL)
+			return ERR_MEMORY;
+		**bound = record->value;
+	}
+	return ERR_OK;
+}
+
+/**
+ * Vytvoreni ukazatele operandu z indexu (mimo cile skoku, ty se doplni
+ * az po vlozeni vsech instrukci)
+ * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode loadPointer(const tCacheSections *cache, const tCacheInstruction *record, int operand,
+                         tFunctionData **functions, tOperand *value)
+{
+	const tCacheOperand *list;
+	String *needle;
+	tRange *range;
+	tVariable *variable;
+	int32_t index = operand == 1 ? record->op1 : operand == 2 ? record->op2 : record->op3;
+
+	value->pointer = NULL;
+	switch (record->instruction)
+	{
+		case INSTR_CALL:
+			value->pointer = functions[index];
+			return ERR_OK;
+
+		case INSTR_PRINT:
+		case INSTR_FIND:
+			if (operand == 2)
+			{
+				value->pointer = loadOperandArray(cache, index);
+				return value->pointer != NULL ? ERR_OK : ERR_MEMORY;
+			}
+			list = &cache->operands[record->op2];
+			needle = constantPoolValue(list[2].value)->value;
+			value->pointer = searchTableCreate(needle->data, needle->length);
+			return value->pointer != NULL ? ERR_OK : ERR_MEMORY;
+
+		case INSTR_MOV:
+			range = malloc(sizeof(tRange));
+			if (range == NULL)
+				return ERR_MEMORY;
+			if (loadRangeBound(&cache->operands[index], &range->off1) != ERR_OK ||
+			    loadRangeBound(&cache->operands[index + 1], &range->off2) != ERR_OK ||
+			    createNewVariable(&variable, RANGE, range) != ERR_OK)
+			{
+				free(range);
+				return ERR_MEMORY;
+			}
+			value->pointer = variable;
+			return ERR_OK;
+
+		default:	// INSTR_GOTO, INSTR_IFGOTO
+			return ERR_OK;
+	}
+}
+
+/**
+ * Vytvoreni instrukci, vlozeni do seznamu instrukci a doplneni skoku
+ * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode loadInstructions(const tCacheSections *cache, tFunctionData **functions, tIListItem **items)
+{
+	ecode error;
+	tInstruction *instruction;
+
+	for (uint32_t i = 0; i < cache->header->instructionCount; i++)
+	{
+		const tCacheInstruction *record = &cache->instructions[i];
+		const uint8_t kinds[3] = { record->kind1, record->kind2, record->kind3 };
+		const int32_t values[3] = { record->op1, record->op2, record->op3 };
+		tOperand operands[3];
+
+		instruction = compileArenaAlloc(sizeof(tInstruction));
+		if (instruction == NULL)
+			return ERR_MEMORY;
+
+		for (int k = 0; k < 3; k++)
+		{
+			if (kinds[k] != OPERAND_POINTER)
+				operands[k] = loadOperand(kinds[k], values[k]);
+			else if ((error = loadPointer(cache, record, k + 1, functions, &operands[k])))
+				return error;
+		}
+
+		instruction->instruction = record->instruction;
+		instruction->kind1 = record->kind1;
+		instruction->kind2 = record->kind2;
+		instruction->kind3 = record->kind3;
+		instruction->op1 = operands[0];
+		instruction->op2 = operands[1];
+		instruction->op3 = operands[2];
+
+		// Operandy MOV a FIND mimo arenu registruje tIListInsertLast
+		_lineNumber = record->line;
+		error = tIListInsertLast(instructionList, instruction);
+		if (error)
+			return error;
+		items[i] = tIListGetLast(instructionList);
+	}
+
+	// -------------- Cile skoku -------------------------------------------------
+	for (uint32_t i = 0; i < cache->header->instructionCount; i++)
+	{
+		instruction = items[i]->instruction;
+		if ((instruction->instruction == INSTR_GOTO || instruction->instruction == INSTR_IFGOTO) &&
+		    instruction->kind1 == OPERAND_POINTER)
+			instruction->op1.pointer = items[cache->instructions[i].op1];
+	}
+
+	for (uint32_t i = 0; i < cache->header->functionCount; i++)
+	{
+		functions[i]->firstInstruction = items[cache->functions[i].firstInstruction];
+		functions[i]->lastInstruction = cache->functions[i].lastInstruction >= 0 ?
+		                                items[cache->functions[i].lastInstruction] : NULL;
+	}
+	return ERR_OK;
+}
+
+// Nacteni prelozeneho programu
+ecode programCacheLoad(const char *path, uint64_t key, bool *loaded)
+{
+	ecode error;
+	struct stat info;
+	tCacheSections cache;
+	tFunctionData **functions;
+	tIListItem **items;
+	void *data;
+	int fd;
+
+	*loaded = false;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return ERR_OK;
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(tCacheHeader))
+	{
+		close(fd);
+		return ERR_OK;
+	}
+	data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return ERR_OK;
+
+	// -------------- Soubor se cely zkontroluje pred zmenou programu -------------
+	// Konstanty se nacitaji na stejne indexy, tabulka musi byt prazdna
+	if (constantPool.count != 0 || !validateCache(data, info.st_size, key, &cache))
+	{
+		munmap(data, info.st_size);
+		return ERR_OK;
+	}
+
+	functions = malloc((cache.header->functionCount + 1) * sizeof(tFunctionData *));
+	items = malloc((cache.header->instructionCount + 1) * sizeof(tIListItem *));
+	if (functions == NULL || items == NULL)
+		error = ERR_MEMORY;
+	else if ((error = loadConstants(&cache)) == ERR_OK && (error = loadFunctions(&cache, functions)) == ERR_OK)
+		error = loadInstructions(&cache, functions, items);
+
+	free(functions);
+	free(items);
+	munmap(data, info.st_size);
+
+	*loaded = error == ERR_OK;
+	return error;
+}
@@ -0,0 +1,125 @@
+// program_cache.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Cache file with the compiled program, keyed by a hash of the source        *
+ ******************************************************************************
+ */
+
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "errnum.h"
+
+// Verze formatu, pri zmene zaznamu se zvysi. Zmeny instrukci a prekladu
+// zachyti otisk sestaveni (programCacheBuildId)
+#define PROGRAM_CACHE_VERSION 2
+
+// Hlavicka souboru. Soubor neobsahuje ukazatele, odkazy na instrukce,
+// funkce, operandy a retezce jsou indexy do jednotlivych sekci, ktere
+// nasleduji za hlavickou v tomto poradi
+typedef struct
+{
+	char magic[8];				// "IFJ12PC"
+	uint32_t version;			// PROGRAM_CACHE_VERSION
+	uint32_t byteOrder;			// 0x01020304 v poradi bajtu zapisujiciho stroje
+	uint64_t key;				// Hash zdrojoveho kodu
+	uint64_t build;				// Otisk sestaveni interpretu (programCacheBuildId)
+	uint32_t functionCount;		// Pocet zaznamu funkci
+	uint32_t constantCount;		// Pocet konstant
+	uint32_t instructionCount;	// Pocet instrukci
+	uint32_t operandCount;		// Pocet zaznamu operandu
+	uint32_t stringSize;		// Velikost sekce retezcu v bajtech
+	uint32_t reserved;
+} tCacheHeader;
+
+// Zaznam funkce, velikost ramce je pocet polozek tabulky symbolu
+typedef struct
+{
+	uint32_t nameOffset;		// Jmeno v sekci retezcu
+	uint32_t nameLength;
+	int32_t paramsCount;
+	int32_t frameSize;
+	int32_t firstInstruction;	// Index instrukce nebo -1
+	int32_t lastInstruction;
+} tCacheFunction;
+
+// Konstanta z tabulky konstant
+typedef struct
+{
+	uint32_t type;				// SemanticType
+	uint32_t stringOffset;		// Retezec v sekci retezcu (STRING)
+	uint32_t stringLength;
+	uint32_t logical;			// Hodnota LOGICAL
+	double number;				// Hodnota NUMERIC
+} tCacheConstant;
+
+// Instrukce s operandy ulozenymi jako v tInstruction, misto ukazatelu
+// je index instrukce (GOTO, IFGOTO), funkce (CALL) nebo operandu (PRINT,
+// FIND, MOV); tabulka posunu FIND se pri nacteni vytvori znovu
+typedef struct
+{
+	uint32_t instruction;		// InstructionType
+	uint8_t kind1, kind2, kind3;
+	uint8_t reserved;
+	int32_t line;				// Radek zdroje
+	int32_t op1, op2, op3;
+} tCacheInstruction;
+
+// Operand seznamu operandu (PRINT, FIND) nebo mezi rozsahu (MOV). Seznam
+// zacina zaznamem s druhem OPERAND_NONE a poctem operandu v hodnote
+typedef struct
+{
+	uint32_t kind;				// OperandKind
+	int32_t value;
+} tCacheOperand;
+
+/**
+ * Klic cache ze zdrojoveho kodu (64bitovy FNV-1a)
+ * @param  data   Zdrojovy kod
+ * @param  length Delka zdrojoveho kodu
+ * @return        Klic cache
+ */
+uint64_t programCacheKey(const char *data, size_t length);
+
+/**
+ * Otisk sestaveni interpretu. Zahrnuje hodnoty vsech instrukci, druhu
+ * operandu a typu konstant, velikosti struktur programu a identifikator
+ * sestaveni PROGRAM_CACHE_BUILD_ID (vychozi je datum a cas prekladu
+ * program_cache.c). Cache z jineho sestaveni se nenacte
+ * @return Otisk sestaveni
+ */
+uint64_t programCacheBuildId();
+
+/**
+ * Zapis prelozeneho programu (instructionList, tabulka konstant a funkce
+ * z indexu tabulek symbolu) do souboru cache. Volat po druhem pruchodu,
+ * dokud je index tabulek symbolu platny. Soubor se zapise pod docasnym
+ * jmenem a prejmenuje, soubezne spusteni tak necte rozepsany soubor
+ * @param  path Cesta k souboru cache
+ * @param  key  Klic zdrojoveho kodu
+ * @return      ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode programCacheSave(const char *path, uint64_t key);
+
+/**
+ * Nacteni prelozeneho programu ze souboru cache do instructionList, tabulky
+ * konstant a tabulky funkci. Soubor se namapuje a cely zkontroluje pred
+ * prvni zmenou programu, chybejici, poskozeny nebo zastaraly soubor
+ * (jiny klic, verze ci sestaveni, opakovana konstanta nebo jmeno funkce)
+ * neni chyba, jen se nenacte. Tabulka konstant musi byt pred nactenim
+ * prazdna. Nacteni neni pouhe namapovani - kazda konstanta, funkce
+ * a instrukce se znovu vytvori, usetri se jen lexikalni a syntakticka analyza
+ * @param  path   Cesta k souboru cache
+ * @param  key    Klic zdrojoveho kodu
+ * @param  loaded Nastavi se na true, pokud byl program nacten
+ * @return        ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode programCacheLoad(const char *path, uint64_t key, bool *loaded);
+
+#endif // PROGRAM_CACHE_H
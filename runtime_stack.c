@@ -11,29 +11,108 @@
 #include "stdlib.h"
 #include "errnum.h"
 #include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include "variable.h"
+#include "constant_pool.h"
+#include "frame_arena.h"
+
+#if !defined(RUNTIME_STACK_USE_MALLOC) && (!defined(MAP_ANONYMOUS) || !defined(MAP_NORESERVE))
+#define RUNTIME_STACK_USE_MALLOC
+#endif
 
 /**
- * Funkce pro realokaci zasobniku. Zvetsi zasobnik o definovany prirustek
+ * Funkce pro realokaci zasobniku. Zdvojnasobi velikost zasobniku
  * @param  stack Ukazatel na zasobnik
  * @return       ERR_OK pokud je vse v poradku
  *               ERR_MEMORY pokud se realokace neporadila
+ *               ERR_STACK_OVERFLOW pokud je zasobnik rezervovan a je plny
  */
 ecode _reallocRuntimeStack(tRuntimeStack *stack);
 
+/**
+ * Rezervace pole zasobniku funkci mmap s ochrannou strankou na konci
+ * @param  stack Ukazatel na zasobnik
+ * @return       true pokud se rezervace povedla
+ */
+static bool _reserveRuntimeStack(tRuntimeStack *stack)
+{
+#ifdef RUNTIME_STACK_USE_MALLOC
+    (void) stack;
+    return false;
+#else
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t reserve = (RUNTIME_STACK_RESERVE + pageSize - 1) & ~(pageSize - 1);
+
+    void *data = mmap(NULL, reserve + pageSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED)
+        return false;
+
+    // Zapis za rezervaci skonci na ochranne strance misto cizi pameti
+    if (mprotect((char *) data + reserve, pageSize, PROT_NONE) != 0)
+    {
+        munmap(data, reserve + pageSize);
+        return false;
+    }
+
+    // Anonymni stranky jsou vynulovane, neni treba inicializace na NULL
+    stack->array = data;
+    stack->size = reserve / sizeof(void*);
+    stack->mapped = true;
+    return true;
+#endif
+}
+
+/**
+ * Vraceni stranek nad vrcholem zasobniku systemu po navratu z hluboke
+ * rekurze. Stranky se pri dalsim pristupu znovu alokuji vynulovane
+ * @param  stack Ukazatel na zasobnik
+ */
+static void _trimRuntimeStack(tRuntimeStack *stack)
+{
+#ifndef RUNTIME_STACK_USE_MALLOC
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    char *from = (char *) &stack->array[stack->sp + 1];
+    char *to = (char *) &stack->array[stack->highWater + 1];
+
+    from = (char *) (((size_t) from + pageSize - 1) & ~(pageSize - 1));
+    if (from < to)
+        madvise(from, to - from, MADV_DONTNEED);
+#endif
+    stack->highWater = stack->sp;
+}
+
 tRuntimeStack* tRuntimeStackInit()
 {
     tRuntimeStack *stack = malloc(sizeof(tRuntimeStack));
     if (stack == NULL)
         return NULL;
 
-    stack->array = calloc(RUNTIME_STACK_ALLOC_STEP, sizeof(void*));
-    stack->size = RUNTIME_STACK_ALLOC_STEP;
+    stack->mapped = false;
+    if (!_reserveRuntimeStack(stack))
+    {
+        stack->array = calloc(RUNTIME_STACK_ALLOC_STEP, sizeof(void*));
+        stack->size = RUNTIME_STACK_ALLOC_STEP;
+    }
     // for (int i = 0; i < stack->size; i++)
     //  stack->array[i] = NULL;
 
     stack->bp = malloc(sizeof(int));
+    if (stack->array == NULL || stack->bp == NULL)
+    {
+        free(stack->bp);
+#ifndef RUNTIME_STACK_USE_MALLOC
+        if (stack->mapped)
+            munmap(stack->array, stack->size * sizeof(void*) + sysconf(_SC_PAGESIZE));
+        else
+#endif
+            free(stack->array);
+        free(stack);
+        return NULL;
+    }
     stack->sp = 0;
+    stack->highWater = 0;
     *(stack->bp) = 0;
     return stack;
 }
@@ -77,6 +156,13 @@ ecode tRuntimeStackMoveSP(tRuntimeStack *stack, int increase)
     }
 
     stack->sp += increase;
+
+    // Sledovani hloubky zasobniku pro vraceni stranek po navratu z rekurze
+    if (stack->sp > stack->highWater)
+        stack->highWater = stack->sp;
+    else if (stack->mapped && stack->highWater - stack->sp > RUNTIME_STACK_TRIM)
+        _trimRuntimeStack(stack);
+
     return ERR_OK;
 }
 
@@ -85,8 +171,8 @@ ecode tRuntimeStackRead(tRuntimeStack *stack, int offset, void **readData)
     // Precteni hodnoty na offsetu
     if ((offset + *(stack->bp)) < 0)
         return ERR_STACK_UNDERFLOW; // mimo zasobnik
-    else if (stack->size < (offset + *(stack->bp)))
-        return ERR_STACK_OVERFLOW;  // za vrcholem zasobniku
+    else if ((offset + *(stack->bp)) > stack->sp)
+        return ERR_STACK_OVERFLOW;  // za vrcholem zasobniku (i ochranna stranka)
     else
         *readData = stack->array[offset + *(stack->bp)];
     return ERR_OK;
@@ -106,8 +192,9 @@ ecode tRuntimeStackPop(tRuntimeStack *stack)
 {
     int error;
 
-    // uvolneni polozky na zasobniku
-    freeVariable((tVariable **) &(stack->array[stack->sp]));
+    // uvolneni polozky na zasobniku, konstanty patri tabulce konstant
+    if (!constantPoolContains(stack->array[stack->sp]))
+        frameArenaReleaseVariable((tVariable **) &(stack->array[stack->sp]));
     // Snizeni vrcholu zasobniku
     error = tRuntimeStackMoveSP(stack, -1);
     if (error != ERR_OK)
@@ -133,7 +220,11 @@ ecode tRuntimeStackPush(tRuntimeStack *stack, void *data)
 ecode _reallocRuntimeStack(tRuntimeStack *stack)
 {
     void **newStack;
-    size_t newSize = stack->size + RUNTIME_STACK_ALLOC_STEP;
+    size_t newSize = (size_t) stack->size * 2;
+
+    // Rezervovany zasobnik se nepresouva, jeho velikost je konecna
+    if (stack->mapped)
+        return ERR_STACK_OVERFLOW;
 
     // Realokace pole zasobniku
     newStack = realloc(stack->array, newSize * sizeof(void*));
@@ -153,6 +244,11 @@ void tRuntimeStackDispose(tRuntimeStack *stack)
         tRuntimeStackPop(stack);
 
     free(stack->bp);
-    free(stack->array);
+#ifndef RUNTIME_STACK_USE_MALLOC
+    if (stack->mapped)
+        munmap(stack->array, stack->size * sizeof(void*) + sysconf(_SC_PAGESIZE));
+    else
+#endif
+        free(stack->array);
     free(stack);
 }
@@ -11,20 +11,38 @@
 #ifndef RUNTIME_STACK_H
 #define RUNTIME_STACK_H
 
+#include <stdbool.h>
 #include "errnum.h"
+// Pocatecni velikost zasobniku alokovaneho funkci malloc, dale se zdvojnasobuje
 #define RUNTIME_STACK_ALLOC_STEP 4000
 
+// Velikost rezervovaneho virtualniho prostoru zasobniku v bajtech, stranky se
+// alokuji az pri prvnim pristupu. Za rezervaci je ochranna stranka
+#ifndef RUNTIME_STACK_RESERVE
+#define RUNTIME_STACK_RESERVE (1024L * 1024 * 1024)
+#endif
+
+// Pocet polozek nad vrcholem, po jejichz uvolneni se stranky vrati systemu
+#ifndef RUNTIME_STACK_TRIM
+#define RUNTIME_STACK_TRIM (256 * 1024)
+#endif
+
 typedef struct
 {
 	void **array; // Pole pro ukladani polozek
 	int size;	// Velikost zasobniku
 	int sp;	// Ukazatel na vrchol zasobniku
 	int *bp; // Ukazatel na base pointer
+	int highWater; // Nejvyssi vrchol od posledniho vraceni stranek
+	bool mapped; // Pole je rezervovano funkci mmap (jinak malloc)
 } tRuntimeStack;
 
 /**
  * Funkce pro vytvoreni a inicializaci behoveho zasobniku
- * @return Vytvoreny a inicializovany zasobnik
+ * Pole zasobniku je rezervovano funkci mmap v rozsahu RUNTIME_STACK_RESERVE,
+ * pokud rezervace selze (nebo je definovano RUNTIME_STACK_USE_MALLOC),
+ * pouzije se malloc s geometrickym zvetsovanim
+ * @return Vytvoreny a inicializovany zasobnik, NULL pri nedostatku pameti
  */
 tRuntimeStack* tRuntimeStackInit();
 
@@ -50,15 +68,15 @@ ecode tRuntimeStackInsert(tRuntimeStack *stack, int offset, void *data);
  * @return            ERR_OK pokud je vse v poradku
  *                    ERR_STACK_UNDERFLOW pokud je offset + base pointer mensi
  *                                        nez velikost zasobniku
- *                    ERR_STACK_OVERFLOW pokud je offset + base pointer vetsi
- *                                       nez velikost zasobniku
+ *                    ERR_STACK_OVERFLOW pokud je offset + base pointer za
+ *                                       vrcholem zasobniku
  */
 ecode tRuntimeStackRead(tRuntimeStack *stack, int offset, void **readData);
 
 /**
  * Funkce pro posunuti vrcholu zasobniku o zadanou hodnotu, pokud
  * neni zasobnik pro pozadovany posun dostatecne velky, dojde k jeho
- * zvetseni
+ * zvetseni (rezervovany zasobnik vrati ERR_STACK_OVERFLOW)
  * @param  stack    Ukazatel na zasobnik
  * @param  increase Hodnota o kterou se zasobnik posune
  * @return          ERR_OK pokud je vse v poradku, jinak prislusny
@@ -0,0 +1,432 @@
+// source_scan.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Source buffer and pre-scanner for function headers                         *
+ ******************************************************************************
+ */
+
+#define _GNU_SOURCE
+#include "source_scan.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__SSE2__) && !defined(SOURCE_SCAN_SCALAR)
+#include <emmintrin.h>
+#define SOURCE_SCAN_SSE2
+#endif
+
+// Makra pro urceni typu znaku
+#define isIdentifierStart(c) (((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z') || (c) == '_')
+#define isIdentifierChar(c) (isIdentifierStart(c) || ((c) >= '0' && (c) <= '9'))
+#define isBlank(c) ((c) == ' ' || (c) == '\t' || (c) == '\r')
+
+// Klicova a rezervovana slova, ktera nemohou byt jmenem funkce ani parametru
+static const char *keywords[] = {
+	"as", "def", "directive", "else", "end", "export", "false", "from", "function",
+	"if", "import", "launch", "load", "macro", "nil", "return", "true", "while",
+};
+
+#define KEYWORD_COUNT ((int) (sizeof(keywords) / sizeof(keywords[0])))
+
+/**
+ * Precteni zdroje, ktery nelze namapovat, po blocich do pameti
+ */
+static ecode sourceRead(FILE *file, tSource *source)
+{
+	size_t size = SOURCE_READ_STEP;
+	size_t count;
+	char *data;
+
+	source->data = malloc(size);
+	if (source->data == NULL)
+		return ERR_MEMORY;
+
+	while ((count = fread(source->data + source->length, 1, size - source->length, file)) > 0)
+	{
+		source->length += count;
+		if (source->length == size)
+		{
+			data = realloc(source->data, size * 2);
+			if (data == NULL)
+				return ERR_MEMORY;
+			source->data = data;
+			size *= 2;
+		}
+	}
+
+	return ferror(file) ? ERR_INTERNAL : ERR_OK;
+}
+
+// Nacteni celeho zdroje
+ecode sourceLoad(FILE *file, tSource *source)
+{
+	struct stat info;
+	void *data;
+
+	source->data = NULL;
+	source->length = 0;
+	source->mapped = false;
+	source->borrowed = false;
+
+	if (fstat(fileno(file), &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+		if (data != MAP_FAILED)
+		{
+			// Zdroj se prochazi sekvencne
+			madvise(data, info.st_size, MADV_SEQUENTIAL);
+			source->data = data;
+			source->length = info.st_size;
+			source->mapped = true;
+			return ERR_OK;
+		}
+	}
+
+	return sourceRead(file, source);
+}
+
+// Zdroj z bufferu volajiciho
+void sourceFromBuffer(const char *data, size_t length, tSource *source)
+{
+	// Buffer se jen cte, neni treba ho kopirovat
+	source->data = (char *) data;
+	source->length = length;
+	source->mapped = false;
+	source->borrowed = true;
+}
+
+// Soubor pro scanner od zacatku zdroje
+FILE *sourceOpen(FILE *file, tSource *source)
+{
+	// Z namapovaneho souboru se necetlo, prazdny precteny zdroj je na konci
+	if (source->mapped || (source->length == 0 && !source->borrowed))
+		return file;
+
+	return fmemopen(source->data, source->length, "r");
+}
+
+// Uvolneni zdroje
+void sourceFree(tSource *source)
+{
+	if (source->mapped)
+		munmap(source->data, source->length);
+	else if (!source->borrowed)
+		free(source->data);
+
+	source->data = NULL;
+	source->length = 0;
+	source->mapped = false;
+	source->borrowed = false;
+}
+
+// Pre-scanner na zacatek zdroje
+void sourceScanInit(tSourceScan *scan, const tSource *source)
+{
+	scan->source = source;
+	scan->position = 0;
+	scan->line = 1;
+	scan->linePosition = 0;
+}
+
+/**
+ * Pozice prvniho z trojice znaku od pozice i, pri neuspechu delka zdroje.
+ * S SSE2 se porovnava 16 znaku najednou, zbytek (a cely zdroj bez SSE2)
+ * se prochazi po znacich
+ */
+static size_t findAny(const char *data, size_t i, size_t length, char a, char b, char c)
+{
+#ifdef SOURCE_SCAN_SSE2
+	const __m128i va = _mm_set1_epi8(a);
+	const __m128i vb = _mm_set1_epi8(b);
+	const __m128i vc = _mm_set1_epi8(c);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i *) (data + i));
+		__m128i match = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)),
+		                             _mm_cmpeq_epi8(chunk, vc));
+		int mask = _mm_movemask_epi8(match);
+		if (mask != 0)
+			return i + __builtin_ctz(mask);
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		if (data[i] == a || data[i] == b || data[i] == c)
+			return i;
+	}
+	return length;
+}
+
+/**
+ * Preskoceni blokoveho komentare zacinajiciho na pozici *i
+ * @return false pro neukonceny komentar
+ */
+static bool skipBlockComment(const char *data, size_t *i, size_t length)
+{
+	const char *star;
+	size_t j = *i + 2;
+
+	while (j < length && (star = memchr(data + j, '*', length - j)) != NULL)
+	{
+		j = star - data + 1;
+		if (j < length && data[j] == '/')
+		{
+			*i = j + 1;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Preskoceni mezer a blokovych komentaru uvnitr hlavicky funkce
+ * @return ERR_OK, pripadne ERR_LEXICAL pro neukonceny komentar
+ */
+static ecode skipBlanks(tSourceScan *scan)
+{
+	const char *data = scan->source->data;
+	size_t length = scan->source->length;
+	size_t i = scan->position;
+
+	while (i < length)
+	{
+		if (isBlank(data[i]))
+			i++;
+		else if (data[i] == '/' && i + 1 < length && data[i + 1] == '*')
+		{
+			if (!skipBlockComment(data, &i, length))
+				return ERR_LEXICAL;
+		}
+		else
+			break;
+	}
+
+	scan->position = i;
+	return ERR_OK;
+}
+
+/**
+ * Nacteni identifikatoru, ktery neni klicovym slovem
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_SYNTAX
+ */
+static ecode readIdentifier(tSourceScan *scan, const char **name, int *nameLength)
+{
+	const char *data = scan->source->data;
+	size_t length = scan->source->length;
+	size_t start = scan->position;
+	size_t i = start;
+
+	if (i >= length || !isIdentifierStart(data[i]))
+		return ERR_SYNTAX;
+
+	while (i < length && isIdentifierChar(data[i]))
+		i++;
+
+	for (int k = 0; k < KEYWORD_COUNT; k++)
+	{
+		if (strlen(keywords[k]) == i - start && memcmp(keywords[k], data + start, i - start) == 0)
+			return ERR_SYNTAX;
+	}
+
+	*name = data + start;
+	*nameLength = i - start;
+	scan->position = i;
+	return ERR_OK;
+}
+
+/**
+ * Nacteni jednoho znaku hlavicky (zavorky nebo carky)
+ * @return true pokud na pozici je znak c
+ */
+static bool readChar(tSourceScan *scan, char c)
+{
+	if (scan->position < scan->source->length && scan->source->data[scan->position] == c)
+	{
+		scan->position++;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Analyza hlavicky funkce za klicovym slovem function
+ * @return ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+static ecode scanHeader(tSourceScan *scan, tFunctionHeader *header)
+{
+	ecode error;
+	const char *param;
+	int paramLength;
+
+	header->paramsCount = 0;
+
+	// -------------- Jmeno funkce a leva zavorka ---------------------------------
+	if ((error = skipBlanks(scan)) || (error = readIdentifier(scan, &header->name, &header->length)))
+		return error;
+	if ((error = skipBlanks(scan)))
+		return error;
+	if (!readChar(scan, '('))
+		return ERR_SYNTAX;
+	if ((error = skipBlanks(scan)))
+		return error;
+	if (readChar(scan, ')'))
+		return ERR_OK;
+
+	// -------------- Parametry oddelene carkou -----------------------------------
+	while (true)
+	{
+		if ((error = readIdentifier(scan, &param, &paramLength)) || (error = skipBlanks(scan)))
+			return error;
+		header->paramsCount++;
+
+		if (readChar(scan, ')'))
+			return ERR_OK;
+		if (!readChar(scan, ','))
+			return ERR_SYNTAX;
+		if ((error = skipBlanks(scan)))
+			return error;
+	}
+}
+
+// Vyhledani dalsi definice funkce
+ecode sourceNextFunction(tSourceScan *scan, tFunctionHeader *header, bool *found)
+{
+	const char *data = scan->source->data;
+	size_t length = scan->source->length;
+	size_t i = scan->position;
+	const char *end;
+
+	// Zajimave jsou jen slovo function, zacatek retezce a zacatek komentare,
+	// ostatni znaky se preskakuji najednou
+	while ((i = findAny(data, i, length, 'f', '"', '/')) < length)
+	{
+		// -------------- Klicove slovo function na zacatku slova ------------------
+		if (data[i] == 'f')
+		{
+			if ((i == 0 || !isIdentifierChar(data[i - 1])) && length - i >= 8 &&
+			    memcmp(data + i, "function", 8) == 0 && (length - i == 8 || !isIdentifierChar(data[i + 8])))
+			{
+				header->begin = i;
+				scan->position = i + 8;
+				*found = true;
+				return scanHeader(scan, header);
+			}
+			i++;
+		}
+		// -------------- Retezcovy literal az po uvozovku mimo escape sekvenci -----
+		else if (data[i] == '"')
+		{
+			for (i = findAny(data, i + 1, length, '"', '\\', '"'); i < length && data[i] == '\\';
+			     i = findAny(data, i + 2, length, '"', '\\', '"'))
+				;
+			if (i >= length)
+				return ERR_LEXICAL;
+			i++;
+		}
+		// -------------- Komentare ------------------------------------------------
+		else if (i + 1 < length && data[i + 1] == '/')
+		{
+			end = memchr(data + i, '\n', length - i);
+			i = end != NULL ? (size_t) (end - data) : length;
+		}
+		else if (i + 1 < length && data[i + 1] == '*')
+		{
+			if (!skipBlockComment(data, &i, length))
+				return ERR_LEXICAL;
+		}
+		else
+			i++;
+	}
+
+	scan->position = length;
+	*found = false;
+	return ERR_OK;
+}
+
+/**
+ * Cislo radku na pozici, radky se pocitaji od naposledy zjistene pozice
+ */
+static int lineAt(tSourceScan *scan, size_t position)
+{
+	const char *data = scan->source->data;
+	const char *newline;
+
+	while ((newline = memchr(data + scan->linePosition, '\n', position - scan->linePosition)) != NULL)
+	{
+		scan->line++;
+		scan->linePosition = newline - data + 1;
+	}
+	scan->linePosition = position;
+	return scan->line;
+}
+
+// Rozsah definice funkce
+ecode sourceFunctionRange(tSourceScan *scan, tFunctionHeader *header)
+{
+	const char *data = scan->source->data;
+	size_t length = scan->source->length;
+	size_t i = scan->position;
+	size_t start;
+	const char *end;
+	int depth = 1;
+
+	header->line = lineAt(scan, header->begin);
+
+	while (i < length && depth > 0)
+	{
+		// -------------- Slova if a while otviraji blok, end ho uzavira ------------
+		// Pocitadlo musi odpovidat gramatice v parser_dropdown.c, nova konstrukce
+		// ukoncena slovem end se musi pridat i sem
+		if (isIdentifierChar(data[i]))
+		{
+			start = i;
+			while (i < length && isIdentifierChar(data[i]))
+				i++;
+
+			if ((i - start == 2 && memcmp(data + start, "if", 2) == 0) ||
+			    (i - start == 5 && memcmp(data + start, "while", 5) == 0))
+				depth++;
+			else if (i - start == 3 && memcmp(data + start, "end", 3) == 0)
+				depth--;
+		}
+		else if (data[i] == '"')
+		{
+			for (i = findAny(data, i + 1, length, '"', '\\', '"'); i < length && data[i] == '\\';
+			     i = findAny(data, i + 2, length, '"', '\\', '"'))
+				;
+			if (i >= length)
+				return ERR_LEXICAL;
+			i++;
+		}
+		else if (data[i] == '/' && i + 1 < length && data[i + 1] == '/')
+		{
+			end = memchr(data + i, '\n', length - i);
+			i = end != NULL ? (size_t) (end - data) : length;
+		}
+		else if (data[i] == '/' && i + 1 < length && data[i + 1] == '*')
+		{
+			if (!skipBlockComment(data, &i, length))
+				return ERR_LEXICAL;
+		}
+		else
+			i++;
+	}
+
+	// Zdroj skoncil pred end k telu funkce
+	if (depth > 0)
+		return ERR_SYNTAX;
+
+	// -------------- Definice konci koncem radku za end ------------------------
+	end = memchr(data + i, '\n', length - i);
+	header->end = end != NULL ? (size_t) (end - data) + 1 : length;
+	header->endLine = lineAt(scan, header->end);
+
+	scan->position = header->end;
+	return ERR_OK;
+}
@@ -0,0 +1,115 @@
+// source_scan.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Source buffer and pre-scanner for function headers                         *
+ ******************************************************************************
+ */
+
+#ifndef SOURCE_SCAN_H
+#define SOURCE_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "errnum.h"
+
+// Velikost bloku pro cteni zdroje, ktery neni obycejny soubor
+#define SOURCE_READ_STEP (64 * 1024)
+
+// Zdrojovy kod nacteny najednou do pameti
+typedef struct
+{
+	char *data;		// Obsah zdroje (neni ukoncen nulou)
+	size_t length;	// Delka zdroje v bajtech
+	bool mapped;	// Obsah je namapovan funkci mmap (jinak malloc)
+	bool borrowed;	// Obsah patri volajicimu a neuvolnuje se
+} tSource;
+
+// Pozice pre-scanneru ve zdroji
+typedef struct
+{
+	const tSource *source;
+	size_t position;
+	int line;				// Cislo radku na pozici linePosition
+	size_t linePosition;	// Pozice, do ktere jsou spocitany radky
+} tSourceScan;
+
+// Hlavicka definice funkce nalezena pre-scannerem
+typedef struct
+{
+	const char *name;	// Jmeno funkce, ukazuje do zdroje
+	int length;			// Delka jmena
+	int paramsCount;	// Pocet parametru
+	size_t begin;		// Pozice klicoveho slova function
+	size_t end;			// Pozice za koncem definice (viz sourceFunctionRange)
+	int line;			// Radek klicoveho slova function
+	int endLine;		// Radek na pozici end
+} tFunctionHeader;
+
+/**
+ * Nacteni celeho zdroje. Obycejny soubor se namapuje funkci mmap a jeho
+ * pozice se nemeni, jiny zdroj (roura, terminal) se precte cely do pameti
+ * @param  file   Zdrojovy soubor
+ * @param  source Struktura pro ulozeni zdroje
+ * @return        ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode sourceLoad(FILE *file, tSource *source);
+
+/**
+ * Zdroj z bufferu volajiciho bez kopirovani. Buffer musi zustat platny,
+ * dokud se zdroj pouziva
+ * @param data   Zdrojovy kod (nemusi byt ukoncen nulou)
+ * @param length Delka zdrojoveho kodu
+ * @param source Struktura pro ulozeni zdroje
+ */
+void sourceFromBuffer(const char *data, size_t length, tSource *source);
+
+/**
+ * Soubor pro scanner, ze ktereho se zdroj precte znovu od zacatku. Namapovany
+ * zdroj se cte z puvodniho souboru, precteny zdroj a zdroj z bufferu
+ * volajiciho pres fmemopen
+ * @param  file   Puvodni zdrojovy soubor (NULL u zdroje z bufferu)
+ * @param  source Nacteny zdroj
+ * @return        Soubor pro scanner nebo NULL pri chybe
+ */
+FILE *sourceOpen(FILE *file, tSource *source);
+
+/**
+ * Uvolneni nacteneho zdroje
+ * @param source Nacteny zdroj
+ */
+void sourceFree(tSource *source);
+
+/**
+ * Inicializace pre-scanneru na zacatek zdroje
+ * @param scan   Pozice pre-scanneru
+ * @param source Nacteny zdroj
+ */
+void sourceScanInit(tSourceScan *scan, const tSource *source);
+
+/**
+ * Vyhledani dalsi definice funkce. Pre-scanner preskakuje komentare
+ * a retezcove literaly a kontroluje jen syntaxi hlavicky funkce, ostatni
+ * chyby zjisti az druhy pruchod
+ * @param  scan   Pozice pre-scanneru
+ * @param  header Struktura pro ulozeni hlavicky
+ * @param  found  Nastavi se na false na konci zdroje
+ * @return        ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode sourceNextFunction(tSourceScan *scan, tFunctionHeader *header, bool *found);
+
+/**
+ * Urceni rozsahu definice funkce, volat hned po nalezeni hlavicky funkci
+ * sourceNextFunction. Najde end k telu funkce (pocita vnorene if a while)
+ * a konec jeho radku, doplni radky hlavicky a pokracuje za definici
+ * @param  scan   Pozice pre-scanneru
+ * @param  header Nalezena hlavicka
+ * @return        ERR_OK pokud je vse v poradku, ERR_LEXICAL pri neukoncenem
+ *                retezci nebo komentari, ERR_SYNTAX pokud chybi end k telu
+ */
+ecode sourceFunctionRange(tSourceScan *scan, tFunctionHeader *header);
+
+#endif // SOURCE_SCAN_H
@@ -0,0 +1,467 @@
+// string_ops.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Operations over string data used by builtin functions and operators        *
+ ******************************************************************************
+ */
+#include "string_ops.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef STRING_SORT_THREADS
+#include <pthread.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STRING_OPS_X86
+#include <immintrin.h>
+#endif
+
+typedef int (*tSearchFunction)(const char *, int, const char *, int);
+
+/**
+ * Skalarni hledani od zadane pozice, kandidati se hledaji pomoci memchr
+ * @param  from Pozice, od ktere se hleda
+ * @return      Index vyskytu nebo -1
+ */
+static int searchScalarFrom(const char *haystack, int haystackLength, const char *needle, int needleLength, int from)
+{
+	const char *position = haystack + from;
+	const char *last = haystack + haystackLength - needleLength;
+
+	while (position <= last)
+	{
+		position = memchr(position, needle[0], last - position + 1);
+		if (position == NULL)
+			return -1;
+
+		if (memcmp(position + 1, needle + 1, needleLength - 1) == 0)
+			return position - haystack;
+		position++;
+	}
+
+	return -1;
+}
+
+// Skalarni hledani pro procesory bez SIMD
+static int searchScalar(const char *haystack, int haystackLength, const char *needle, int needleLength)
+{
+	return searchScalarFrom(haystack, haystackLength, needle, needleLength, 0);
+}
+
+#ifdef STRING_OPS_X86
+#ifdef __SSE2__
+/**
+ * Hledani s filtrem na prvni a posledni znak podretezce po 16 bajtech,
+ * zbytek retezce se dohleda skalarne. Predpoklada needleLength >= 2
+ */
+static int searchSse2(const char *haystack, int haystackLength, const char *needle, int needleLength)
+{
+	const __m128i first = _mm_set1_epi8(needle[0]);
+	const __m128i last = _mm_set1_epi8(needle[needleLength - 1]);
+	unsigned int mask;
+	int i;
+
+	for (i = 0; i + needleLength + 15 <= haystackLength; i += 16)
+	{
+		__m128i blockFirst = _mm_loadu_si128((const __m128i *) (haystack + i));
+		__m128i blockLast = _mm_loadu_si128((const __m128i *) (haystack + i + needleLength - 1));
+
+		mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst),
+		                                       _mm_cmpeq_epi8(last, blockLast)));
+		while (mask != 0)
+		{
+			int bit = __builtin_ctz(mask);
+			if (memcmp(haystack + i + bit + 1, needle + 1, needleLength - 2) == 0)
+				return i + bit;
+			mask &= mask - 1;
+		}
+	}
+
+	return searchScalarFrom(haystack, haystackLength, needle, needleLength, i);
+}
+#endif // __SSE2__
+
+/**
+ * Hledani s filtrem na prvni a posledni znak podretezce po 32 bajtech,
+ * prelozeno pro AVX2 bez ohledu na prepinace prekladace
+ */
+__attribute__((target("avx2")))
+static int searchAvx2(const char *haystack, int haystackLength, const char *needle, int needleLength)
+{
+	const __m256i first = _mm256_set1_epi8(needle[0]);
+	const __m256i last = _mm256_set1_epi8(needle[needleLength - 1]);
+	unsigned int mask;
+	int i;
+
+	for (i = 0; i + needleLength + 31 <= haystackLength; i += 32)
+	{
+		__m256i blockFirst = _mm256_loadu_si256((const __m256i *) (haystack + i));
+		__m256i blockLast = _mm256_loadu_si256((const __m256i *) (haystack + i + needleLength - 1));
+
+		mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst),
+		                                             _mm256_cmpeq_epi8(last, blockLast)));
+		while (mask != 0)
+		{
+			int bit = __builtin_ctz(mask);
+			if (memcmp(haystack + i + bit + 1, needle + 1, needleLength - 2) == 0)
+				return i + bit;
+			mask &= mask - 1;
+		}
+	}
+
+	return searchScalarFrom(haystack, haystackLength, needle, needleLength, i);
+}
+#endif // STRING_OPS_X86
+
+/**
+ * Vyber implementace hledani podle schopnosti procesoru, provadi se jednou
+ * pri prvnim volani
+ * @return Ukazatel na nejrychlejsi dostupnou implementaci
+ */
+static tSearchFunction selectSearchFunction()
+{
+#ifdef STRING_OPS_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return searchAvx2;
+#ifdef __SSE2__
+	return searchSse2;
+#endif
+#endif
+	return searchScalar;
+}
+
+/**
+ * Vypocet maximalni pripony podretezce pro kritickou faktorizaci
+ * @param  needle       Hledany podretezec
+ * @param  needleLength Delka podretezce
+ * @param  period       Ukazatel pro ulozeni periody pripony
+ * @param  reversed     Pokud je nenulove, pouzije se obracene usporadani znaku
+ * @return              Index posledniho znaku pred maximalni priponou
+ */
+static int maximalSuffix(const unsigned char *needle, int needleLength, int *period, int reversed)
+{
+	int suffix = -1;
+	int j = 0;
+	int k = 1;
+	unsigned char a, b;
+
+	*period = 1;
+	while (j + k < needleLength)
+	{
+		a = needle[j + k];
+		b = needle[suffix + k];
+		if (a == b)
+		{
+			if (k != *period)
+				k++;
+			else
+			{
+				j += *period;
+				k = 1;
+			}
+		}
+		else if ((a < b) != (reversed != 0))
+		{
+			j += k;
+			k = 1;
+			*period = j - suffix;
+		}
+		else
+		{
+			suffix = j;
+			j = suffix + 1;
+			k = *period = 1;
+		}
+	}
+
+	return suffix;
+}
+
+/**
+ * Hledani algoritmem Two-Way (Crochemore-Perrin) s linearni slozitosti
+ * a konstantni pametovou narocnosti
+ */
+static int searchTwoWay(const char *haystack, int haystackLength, const char *needle, int needleLength)
+{
+	const unsigned char *x = (const unsigned char *) needle;
+	const unsigned char *y = (const unsigned char *) haystack;
+	int suffix, suffixReversed, critical, period, periodReversed;
+	int memory, i, j;
+
+	// -------------- Kriticka faktorizace podretezce ---------------------------
+	suffix = maximalSuffix(x, needleLength, &period, 0);
+	suffixReversed = maximalSuffix(x, needleLength, &periodReversed, 1);
+	if (suffix > suffixReversed)
+		critical = suffix;
+	else
+	{
+		critical = suffixReversed;
+		period = periodReversed;
+	}
+
+	// -------------- Periodicky podretezec -------------------------------------
+	if (memcmp(x, x + period, critical + 1) == 0)
+	{
+		j = 0;
+		memory = -1;
+		while (j <= haystackLength - needleLength)
+		{
+			i = (critical > memory ? critical : memory) + 1;
+			while (i < needleLength && x[i] == y[i + j])
+				i++;
+
+			if (i >= needleLength)
+			{
+				i = critical;
+				while (i > memory && x[i] == y[i + j])
+					i--;
+				if (i <= memory)
+					return j;
+				j += period;
+				memory = needleLength - period - 1;
+			}
+			else
+			{
+				j += i - critical;
+				memory = -1;
+			}
+		}
+	}
+	// -------------- Neperiodicky podretezec -----------------------------------
+	else
+	{
+		period = (critical + 1 > needleLength - critical - 1 ? critical + 1 : needleLength - critical - 1) + 1;
+		j = 0;
+		while (j <= haystackLength - needleLength)
+		{
+			i = critical + 1;
+			while (i < needleLength && x[i] == y[i + j])
+				i++;
+
+			if (i >= needleLength)
+			{
+				i = critical;
+				while (i >= 0 && x[i] == y[i + j])
+					i--;
+				if (i < 0)
+					return j;
+				j += period;
+			}
+			else
+				j += i - critical;
+		}
+	}
+
+	return -1;
+}
+
+// Vyhledani prvniho vyskytu podretezce
+int stringSearch(const char *haystack, int haystackLength, const char *needle, int needleLength)
+{
+	static tSearchFunction searchFunction = NULL;
+	const char *found;
+
+	// Prazdny podretezec se nachazi na zacatku
+	if (needleLength == 0)
+		return 0;
+
+	if (needleLength > haystackLength)
+		return -1;
+
+	// Jeden znak
+	if (needleLength == 1)
+	{
+		found = memchr(haystack, needle[0], haystackLength);
+		return found == NULL ? -1 : found - haystack;
+	}
+
+	if (needleLength >= STRING_SEARCH_TWO_WAY_THRESHOLD)
+		return searchTwoWay(haystack, haystackLength, needle, needleLength);
+
+	if (searchFunction == NULL)
+		searchFunction = selectSearchFunction();
+
+	return searchFunction(haystack, haystackLength, needle, needleLength);
+}
+
+// Vytvoreni tabulky pro konstantni podretezec
+tSearchTable *searchTableCreate(const char *needle, int needleLength)
+{
+	tSearchTable *table = malloc(sizeof(tSearchTable));
+	if (table == NULL)
+		return NULL;
+
+	table->needle = needle;
+	table->needleLength = needleLength;
+	table->built = 0;
+	return table;
+}
+
+// Vyhledani konstantniho podretezce pomoci tabulky posunu
+int searchTableFind(tSearchTable *table, const char *haystack, int haystackLength)
+{
+	const unsigned char *text = (const unsigned char *) haystack;
+	const unsigned char *pattern = (const unsigned char *) table->needle;
+	int last = table->needleLength - 1;
+	int i;
+
+	// Kratke podretezce hleda rychleji SIMD filtr
+	if (table->needleLength < SEARCH_TABLE_MIN_LENGTH)
+		return stringSearch(haystack, haystackLength, table->needle, table->needleLength);
+
+	if (table->needleLength > haystackLength)
+		return -1;
+
+	// -------------- Vypocet tabulky posunu pri prvnim pouziti -----------------
+	if (!table->built)
+	{
+		for (i = 0; i < 256; i++)
+			table->shift[i] = table->needleLength;
+		for (i = 0; i < last; i++)
+			table->shift[pattern[i]] = last - i;
+		table->built = 1;
+	}
+
+	// -------------- Hledani podle posledniho znaku okna -----------------------
+	i = 0;
+	while (i <= haystackLength - table->needleLength)
+	{
+		unsigned char c = text[i + last];
+		if (c == pattern[last] && memcmp(text + i, pattern, last) == 0)
+			return i;
+		i += table->shift[c];
+	}
+
+	return -1;
+}
+
+// Lexikograficke porovnani dvou retezcu
+int stringBytesCompare(const char *first, int firstLength, const char *second, int secondLength)
+{
+	int result;
+
+	// memcmp z libc porovnava po vektorovych blocich
+	result = memcmp(first, second, firstLength < secondLength ? firstLength : secondLength);
+	if (result != 0)
+		return result;
+
+	// Shodny zacatek, kratsi retezec je mensi
+	return firstLength - secondLength;
+}
+
+/**
+ * Spocitani vyskytu bajtu do histogramu. Ctyri nezavisle histogramy
+ * odstrani zavislost po sobe jdoucich zapisu do stejneho pocitadla,
+ * data se ctou po osmi bajtech
+ * @param data      Data
+ * @param length    Delka dat
+ * @param histogram Histogram o 256 polozkach, vysledky se pricitaji
+ */
+static void countBytes(const unsigned char *data, size_t length, size_t *histogram)
+{
+	size_t counts[4][256];
+	unsigned long long block;
+	size_t i;
+	int c;
+
+	memset(counts, 0, sizeof(counts));
+
+	for (i = 0; i + 8 <= length; i += 8)
+	{
+		memcpy(&block, data + i, 8);
+		counts[0][block & 0xff]++;
+		counts[1][(block >> 8) & 0xff]++;
+		counts[2][(block >> 16) & 0xff]++;
+		counts[3][(block >> 24) & 0xff]++;
+		counts[0][(block >> 32) & 0xff]++;
+		counts[1][(block >> 40) & 0xff]++;
+		counts[2][(block >> 48) & 0xff]++;
+		counts[3][block >> 56]++;
+	}
+	for (; i < length; i++)
+		counts[0][data[i]]++;
+
+	for (c = 0; c < 256; c++)
+		histogram[c] += counts[0][c] + counts[1][c] + counts[2][c] + counts[3][c];
+}
+
+#ifdef STRING_SORT_THREADS
+// Cast dat pro vypocet histogramu v samostatnem vlakne
+typedef struct
+{
+	const unsigned char *data;
+	size_t length;
+	size_t histogram[256];
+} tHistogramPart;
+
+// Vlakno pocitajici histogram sve casti dat
+static void *countBytesThread(void *argument)
+{
+	tHistogramPart *part = argument;
+	countBytes(part->data, part->length, part->histogram);
+	return NULL;
+}
+
+/**
+ * Vypocet histogramu ve STRING_SORT_THREAD_COUNT vlaknech, pokud se
+ * nektere vlakno nepodari vytvorit, spocita jeho cast volajici vlakno
+ */
+static void countBytesParallel(const unsigned char *data, size_t length, size_t *histogram)
+{
+	tHistogramPart parts[STRING_SORT_THREAD_COUNT];
+	pthread_t threads[STRING_SORT_THREAD_COUNT];
+	int started[STRING_SORT_THREAD_COUNT];
+	size_t partLength = length / STRING_SORT_THREAD_COUNT;
+	int t, c;
+
+	for (t = 0; t < STRING_SORT_THREAD_COUNT; t++)
+	{
+		parts[t].data = data + t * partLength;
+		parts[t].length = (t == STRING_SORT_THREAD_COUNT - 1) ? length - t * partLength : partLength;
+		memset(parts[t].histogram, 0, sizeof(parts[t].histogram));
+		started[t] = pthread_create(&threads[t], NULL, countBytesThread, &parts[t]) == 0;
+		if (!started[t])
+			countBytes(parts[t].data, parts[t].length, parts[t].histogram);
+	}
+
+	for (t = 0; t < STRING_SORT_THREAD_COUNT; t++)
+	{
+		if (started[t])
+			pthread_join(threads[t], NULL);
+		for (c = 0; c < 256; c++)
+			histogram[c] += parts[t].histogram[c];
+	}
+}
+#endif // STRING_SORT_THREADS
+
+// Serazeni znaku retezce pocitanim vyskytu
+void stringSortBytes(char *data, int length)
+{
+	size_t histogram[256];
+	char *position = data;
+	int c;
+
+	if (length < 2)
+		return;
+
+	memset(histogram, 0, sizeof(histogram));
+
+#ifdef STRING_SORT_THREADS
+	if (length >= STRING_SORT_PARALLEL_THRESHOLD)
+		countBytesParallel((const unsigned char *) data, length, histogram);
+	else
+#endif
+	countBytes((const unsigned char *) data, length, histogram);
+
+	// -------------- Zapis serazenych znaku po souvislych usecich --------------
+	for (c = 0; c < 256; c++)
+	{
+		memset(position, c, histogram[c]);
+		position += histogram[c];
+	}
+}
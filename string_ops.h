@@ -0,0 +1,100 @@
+// string_ops.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Operations over string data used by builtin functions and operators        *
+ ******************************************************************************
+ */
+
+#ifndef STRING_OPS_H
+#define STRING_OPS_H
+
+#include <string.h>
+
+// Od teto delky hledaneho retezce se pouziva algoritmus Two-Way,
+// ktery ma i v nejhorsim pripade linearni slozitost
+#define STRING_SEARCH_TWO_WAY_THRESHOLD 64
+
+// Nejmensi delka podretezce, pro kterou se vyplati tabulka posunu,
+// kratsi podretezce se hledaji funkci stringSearch
+#define SEARCH_TABLE_MIN_LENGTH 4
+
+// Od teto delky se pri razeni pocita histogram ve vice vlaknech,
+// pouze pokud je definovano STRING_SORT_THREADS
+#ifndef STRING_SORT_PARALLEL_THRESHOLD
+#define STRING_SORT_PARALLEL_THRESHOLD (4 * 1024 * 1024)
+#endif
+#ifndef STRING_SORT_THREAD_COUNT
+#define STRING_SORT_THREAD_COUNT 4
+#endif
+
+// Predpocitana tabulka posunu (Boyer-Moore-Horspool) pro konstantni podretezec
+typedef struct
+{
+	const char *needle;	// Hledany podretezec, vlastni ho literal v instrukci
+	int needleLength;	// Delka hledaneho podretezce
+	int built;			// Priznak, zda uz byla tabulka posunu vypocitana
+	int shift[256];		// Posun podle znaku pod poslednim znakem podretezce
+} tSearchTable;
+
+/**
+ * Vyhledani prvniho vyskytu podretezce v retezci. Kratke podretezce se
+ * hledaji filtrem na prvni a posledni znak pomoci SSE2/AVX2 (podle
+ * podpory procesoru), dlouhe algoritmem Two-Way
+ * @param  haystack       Prohledavany retezec
+ * @param  haystackLength Delka prohledavaneho retezce
+ * @param  needle         Hledany podretezec
+ * @param  needleLength   Delka hledaneho podretezce
+ * @return                Index prvniho vyskytu od nuly, -1 pokud podretezec
+ *                        nebyl nalezen, 0 pro prazdny podretezec
+ */
+int stringSearch(const char *haystack, int haystackLength, const char *needle, int needleLength);
+
+/**
+ * Vytvoreni tabulky pro konstantni podretezec, samotna tabulka posunu se
+ * vypocita az pri prvnim hledani
+ * @param  needle       Hledany podretezec, musi existovat po celou dobu
+ *                      existence tabulky
+ * @param  needleLength Delka hledaneho podretezce
+ * @return              Ukazatel na tabulku nebo NULL pri nedostatku pameti
+ */
+tSearchTable *searchTableCreate(const char *needle, int needleLength);
+
+/**
+ * Vyhledani prvniho vyskytu konstantniho podretezce pomoci tabulky posunu,
+ * vysledek je stejny jako u funkce stringSearch
+ * @param  table          Tabulka podretezce
+ * @param  haystack       Prohledavany retezec
+ * @param  haystackLength Delka prohledavaneho retezce
+ * @return                Index prvniho vyskytu od nuly nebo -1
+ */
+int searchTableFind(tSearchTable *table, const char *haystack, int haystackLength);
+
+/**
+ * Lexikograficke porovnani dvou retezcu se znamou delkou, bajty se
+ * porovnavaji bez znamenka
+ * @return Zaporne cislo, nula nebo kladne cislo podle toho, zda je prvni
+ *         retezec mensi, roven nebo vetsi nez druhy
+ */
+int stringBytesCompare(const char *first, int firstLength, const char *second, int secondLength);
+
+/**
+ * Test rovnosti dvou retezcu, retezce ruzne delky se neporovnavaji
+ * @return 1 pokud jsou retezce shodne, jinak 0
+ */
+static inline int stringBytesEqual(const char *first, int firstLength, const char *second, int secondLength)
+{
+	return firstLength == secondLength && memcmp(first, second, firstLength) == 0;
+}
+
+/**
+ * Serazeni znaku retezce na miste podle jejich hodnoty (bez znamenka)
+ * pocitanim vyskytu jednotlivych bajtu v linearnim case
+ * @param data   Razena data
+ * @param length Delka dat
+ */
+void stringSortBytes(char *data, int length);
+
+#endif // STRING_OPS_H
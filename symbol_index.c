@@ -0,0 +1,331 @@
+// symbol_index.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Hash index over the symbol and function tables used during compilation     *
+ ******************************************************************************
+ */
+
+#include "symbol_index.h"
+#include "errnum.h"
+#include "global.h"
+#include "compile_arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+tSymbolIndex symbolIndex = { NULL, 0, 0, NULL, 0, 0 };
+
+// Vestavene funkce jsou v tabulce funkci od inicializace interpretu
+static const struct
+{
+	const char *name;
+	ParsedFunction function;
+} builtins[] = {
+	{ "typeOf", FUNCTION_TYPEOF },
+	{ "print", FUNCTION_PRINT },
+	{ "find", FUNCTION_FIND },
+	{ "input", FUNCTION_INPUT },
+	{ "numeric", FUNCTION_NUMERIC },
+	{ "len", FUNCTION_LEN },
+	{ "sort", FUNCTION_SORT },
+};
+
+#define BUILTIN_COUNT ((int) (sizeof(builtins) / sizeof(builtins[0])))
+
+/**
+ * Hash jmena (FNV-1a)
+ */
+static unsigned int nameHash(const char *data, int length)
+{
+	unsigned int hash = 2166136261u;
+	for (int i = 0; i < length; i++)
+	{
+		hash ^= (unsigned char) data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// -------------- Tabulka jmen -------------------------------------------------
+
+/**
+ * Vyhledani jmena v tabulce jmen, pri neuspechu vrati volnou pozici
+ */
+static tName **findName(const char *data, int length, unsigned int hash)
+{
+	unsigned int slot = hash & (symbolIndex.nameSize - 1);
+	tName *name;
+
+	while ((name = symbolIndex.names[slot]) != NULL)
+	{
+		if (name->hash == hash && name->key.length == length && memcmp(name->data, data, length) == 0)
+			break;
+
+		slot = (slot + 1) & (symbolIndex.nameSize - 1);
+	}
+
+	return &symbolIndex.names[slot];
+}
+
+/**
+ * Zvetseni tabulky jmen na dvojnasobek
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode growNames()
+{
+	tName **oldNames = symbolIndex.names;
+	int oldSize = symbolIndex.nameSize;
+
+	symbolIndex.names = calloc(oldSize * 2, sizeof(tName *));
+	if (symbolIndex.names == NULL)
+	{
+		symbolIndex.names = oldNames;
+		return ERR_MEMORY;
+	}
+	symbolIndex.nameSize = oldSize * 2;
+
+	for (int i = 0; i < oldSize; i++)
+	{
+		if (oldNames[i] != NULL)
+			*findName(oldNames[i]->data, oldNames[i]->key.length, oldNames[i]->hash) = oldNames[i];
+	}
+
+	free(oldNames);
+	return ERR_OK;
+}
+
+/**
+ * Vlozeni jmena do tabulky jmen, existujici jmeno se jen vrati
+ * @return Jmeno z tabulky jmen nebo NULL pri nedostatku pameti
+ */
+static const tName *internName(const char *data, int length, ParsedFunction function)
+{
+	unsigned int hash = nameHash(data, length);
+	tName **slot = findName(data, length, hash);
+	tName *name;
+
+	if (*slot != NULL)
+		return *slot;
+
+	// Zaplneni nejvyse do poloviny
+	if (2 * (symbolIndex.nameCount + 1) > symbolIndex.nameSize)
+	{
+		if (growNames() != ERR_OK)
+			return NULL;
+		slot = findName(data, length, hash);
+	}
+
+	name = calloc(1, sizeof(tName) + length + 1);
+	if (name == NULL)
+		return NULL;
+	memcpy(name->data, data, length);
+	name->key.data = name->data;
+	name->key.length = length;
+	name->hash = hash;
+	name->function = function;
+
+	*slot = name;
+	symbolIndex.nameCount++;
+	return name;
+}
+
+// -------------- Index tabulek ------------------------------------------------
+
+/**
+ * Pozice v indexu pro jmeno v dane tabulce
+ */
+static unsigned int entrySlot(tTableHead *table, const tName *name)
+{
+	uintptr_t pointer = (uintptr_t) table;
+	return (name->hash ^ (unsigned int) (pointer >> 4) * 2654435761u) & (symbolIndex.size - 1);
+}
+
+/**
+ * Vyhledani polozky indexu, pri neuspechu vrati volnou pozici pro vlozeni
+ */
+static tSymbolIndexEntry *findEntry(tTableHead *table, const tName *name)
+{
+	unsigned int slot = entrySlot(table, name);
+	tSymbolIndexEntry *entry;
+
+	while ((entry = &symbolIndex.entries[slot])->table != NULL)
+	{
+		if (entry->name == name && entry->table == table)
+			return entry;
+
+		slot = (slot + 1) & (symbolIndex.size - 1);
+	}
+
+	return entry;
+}
+
+/**
+ * Zvetseni indexu na dvojnasobek a prevlozeni polozek
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode growIndex()
+{
+	tSymbolIndexEntry *oldEntries = symbolIndex.entries;
+	int oldSize = symbolIndex.size;
+
+	symbolIndex.entries = calloc(oldSize * 2, sizeof(tSymbolIndexEntry));
+	if (symbolIndex.entries == NULL)
+	{
+		symbolIndex.entries = oldEntries;
+		return ERR_MEMORY;
+	}
+	symbolIndex.size = oldSize * 2;
+
+	for (int i = 0; i < oldSize; i++)
+	{
+		if (oldEntries[i].table != NULL)
+			*findEntry(oldEntries[i].table, oldEntries[i].name) = oldEntries[i];
+	}
+
+	free(oldEntries);
+	return ERR_OK;
+}
+
+/**
+ * Zapis polozky do indexu
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+static ecode addEntry(tTableHead *table, tTableItem *item, const tName *name)
+{
+	tSymbolIndexEntry *entry;
+
+	// Zaplneni nejvyse do poloviny
+	if (2 * (symbolIndex.count + 1) > symbolIndex.size && growIndex() != ERR_OK)
+		return ERR_MEMORY;
+
+	entry = findEntry(table, name);
+	entry->table = table;
+	entry->name = name;
+	entry->item = item;
+	symbolIndex.count++;
+	return ERR_OK;
+}
+
+// Vytvoreni prazdneho indexu
+ecode symbolIndexInit()
+{
+	symbolIndex.entries = calloc(SYMBOL_INDEX_INIT, sizeof(tSymbolIndexEntry));
+	symbolIndex.names = calloc(SYMBOL_NAMES_INIT, sizeof(tName *));
+	symbolIndex.size = SYMBOL_INDEX_INIT;
+	symbolIndex.nameSize = SYMBOL_NAMES_INIT;
+	symbolIndex.count = symbolIndex.nameCount = 0;
+	if (symbolIndex.entries == NULL || symbolIndex.names == NULL)
+	{
+		symbolIndexFree();
+		return ERR_MEMORY;
+	}
+
+	// Jmena vestavenych funkci nesou druh vestavene funkce
+	for (int i = 0; i < BUILTIN_COUNT; i++)
+	{
+		if (internName(builtins[i].name, strlen(builtins[i].name), builtins[i].function) == NULL)
+		{
+			symbolIndexFree();
+			return ERR_MEMORY;
+		}
+	}
+
+	return ERR_OK;
+}
+
+// Vlozeni polozky do tabulky a do indexu
+ecode symbolIndexInsert(tTableHead *table, String *key, ItemType type, void *data)
+{
+	ecode error;
+	tTableItem *item;
+	const tName *name;
+
+	name = internName(key->data, key->length, FUNCTION_OTHER);
+	if (name == NULL)
+		return ERR_MEMORY;
+
+	// Strom zustava kvuli interpretu a uvolneni dat, vlozeni stoji O(hloubka)
+	error = insertItem(table, key, type, data);
+	if (error)
+		return error;
+
+	// Index vraci vlastni kopii polozky, uzel stromu se nehleda. Parser z ni
+	// cte jen data, ktera jsou stejna jako v uzlu stromu
+	item = compileArenaAlloc(sizeof(tTableItem));
+	if (item == NULL)
+		return ERR_MEMORY;
+	memset(item, 0, sizeof(tTableItem));
+	item->key = key;
+	item->type = type;
+	item->data = data;
+
+	return addEntry(table, item, name);
+}
+
+// Vyhledani jmena v tabulce jmen
+const tName *symbolIndexName(String *key)
+{
+	return *findName(key->data, key->length, nameHash(key->data, key->length));
+}
+
+// Vyhledani polozky podle jmena z tabulky jmen
+tTableItem *symbolIndexFind(tTableHead *table, const tName *name)
+{
+	tSymbolIndexEntry *entry;
+	tTableItem *item;
+
+	if (name == NULL)
+		return NULL;
+
+	entry = findEntry(table, name);
+	if (entry->table != NULL)
+		return entry->item;
+
+	// -------------- Vestavene funkce nevklada parser, index se doplni ----------
+	if (table == functionTable && name->function != FUNCTION_OTHER)
+	{
+		item = searchItem(functionTable, (String *) &name->key);
+		// Pri nedostatku pameti se funkce jen nezapamatuje v indexu
+		if (item != NULL)
+			addEntry(functionTable, item, name);
+		return item;
+	}
+
+	return NULL;
+}
+
+// Vyhledani polozky tabulky podle jmena
+tTableItem *symbolIndexSearch(tTableHead *table, String *key)
+{
+	return symbolIndexFind(table, symbolIndexName(key));
+}
+
+// Vyhledani funkce a urceni vestavene funkce
+tTableItem *symbolIndexSearchFunction(String *key, ParsedFunction *function)
+{
+	const tName *name = symbolIndexName(key);
+	tTableItem *item = symbolIndexFind(functionTable, name);
+
+	*function = item != NULL ? name->function : FUNCTION_OTHER;
+	return item;
+}
+
+// Uvolneni indexu
+void symbolIndexFree()
+{
+	if (symbolIndex.names != NULL)
+	{
+		for (int i = 0; i < symbolIndex.nameSize; i++)
+			free(symbolIndex.names[i]);
+	}
+
+	free(symbolIndex.names);
+	free(symbolIndex.entries);
+	symbolIndex.names = NULL;
+	symbolIndex.entries = NULL;
+	symbolIndex.count = symbolIndex.size = 0;
+	symbolIndex.nameCount = symbolIndex.nameSize = 0;
+}
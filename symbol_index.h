@@ -0,0 +1,115 @@
+// symbol_index.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Hash index over the symbol and function tables used during compilation     *
+ ******************************************************************************
+ */
+
+#ifndef SYMBOL_INDEX_H
+#define SYMBOL_INDEX_H
+
+#include "errnum.h"
+#include "ial.h"
+#include "libstring.h"
+
+// Pocatecni velikost rozptylovaci tabulky (mocnina dvou)
+#define SYMBOL_INDEX_INIT 256
+// Pocatecni velikost tabulky jmen (mocnina dvou)
+#define SYMBOL_NAMES_INIT 256
+
+// Vestavene funkce, FUNCTION_OTHER je funkce definovana v programu
+typedef enum { FUNCTION_PRINT, FUNCTION_TYPEOF, FUNCTION_FIND, FUNCTION_INPUT, FUNCTION_NUMERIC, FUNCTION_LEN, FUNCTION_SORT, FUNCTION_OTHER} ParsedFunction;
+
+// Jmeno v tabulce jmen, kazde ruzne jmeno je v tabulce prave jednou, jmena
+// se proto porovnavaji ukazatelem
+typedef struct
+{
+	String key;					// Jmeno (data jsou soucasti polozky)
+	unsigned int hash;			// Predpocitany hash jmena
+	ParsedFunction function;	// Vestavena funkce tohoto jmena nebo FUNCTION_OTHER
+	char data[];				// Znaky jmena
+} tName;
+
+// Polozka indexu, klicem je tabulka a jmeno z tabulky jmen
+typedef struct
+{
+	tTableHead *table;			// Tabulka, do ktere polozka patri (NULL = volno)
+	const tName *name;			// Jmeno polozky
+	tTableItem *item;			// Polozka stromu tabulky
+} tSymbolIndexEntry;
+
+// Index vsech tabulek symbolu a tabulky funkci
+typedef struct
+{
+	tSymbolIndexEntry *entries;
+	int count;					// Pocet polozek
+	int size;					// Velikost tabulky (mocnina dvou)
+	tName **names;				// Tabulka jmen
+	int nameCount;				// Pocet jmen
+	int nameSize;				// Velikost tabulky jmen (mocnina dvou)
+} tSymbolIndex;
+
+extern tSymbolIndex symbolIndex;
+
+/**
+ * Vytvoreni prazdneho indexu, volat pred prekladem programu
+ * @return ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+ecode symbolIndexInit();
+
+/**
+ * Vlozeni polozky do tabulky (stromu) a do indexu. Vsechna jmena, ktera
+ * parser hleda funkci symbolIndexSearch, se musi vkladat touto funkci.
+ * Vlozeni do stromu stoji dal O(hloubka stromu), index si ale uklada
+ * vlastni kopii polozky (v arene prekladu) a strom znovu neprochazi
+ * @param  table Tabulka symbolu nebo tabulka funkci
+ * @param  key   Jmeno polozky, tabulka prebira jeho vlastnictvi
+ * @param  type  Typ polozky
+ * @param  data  Data polozky
+ * @return       ERR_OK pokud je vse v poradku, jinak prislusny chybovy kod
+ */
+ecode symbolIndexInsert(tTableHead *table, String *key, ItemType type, void *data);
+
+/**
+ * Vyhledani jmena v tabulce jmen. Jmeno, ktere v tabulce neni, neni ani
+ * v zadne tabulce symbolu. Vysledek lze pouzit pro vice hledani
+ * funkci symbolIndexFind, retezec se pak prochazi jen jednou
+ * @param  key Hledane jmeno
+ * @return     Jmeno z tabulky jmen nebo NULL
+ */
+const tName *symbolIndexName(String *key);
+
+/**
+ * Vyhledani polozky tabulky podle jmena z tabulky jmen
+ * @param  table Tabulka symbolu nebo tabulka funkci
+ * @param  name  Jmeno z funkce symbolIndexName (NULL = nenalezeno)
+ * @return       Polozka tabulky nebo NULL, pokud jmeno v tabulce neni
+ */
+tTableItem *symbolIndexFind(tTableHead *table, const tName *name);
+
+/**
+ * Vyhledani polozky tabulky podle jmena bez pruchodu stromem
+ * @param  table Tabulka symbolu nebo tabulka funkci
+ * @param  key   Hledane jmeno
+ * @return       Polozka tabulky nebo NULL, pokud jmeno v tabulce neni
+ */
+tTableItem *symbolIndexSearch(tTableHead *table, String *key);
+
+/**
+ * Vyhledani funkce v tabulce funkci a urceni, zda jde o vestavenou funkci
+ * @param  key      Jmeno funkce
+ * @param  function Ukazatel pro ulozeni vestavene funkce (FUNCTION_OTHER
+ *                  pro funkci definovanou v programu)
+ * @return          Polozka tabulky funkci nebo NULL pro nedefinovanou funkci
+ */
+tTableItem *symbolIndexSearchFunction(String *key, ParsedFunction *function);
+
+/**
+ * Uvolneni indexu a tabulky jmen, tabulky (stromy) zustavaji
+ */
+void symbolIndexFree();
+
+#endif // SYMBOL_INDEX_H
@@ -0,0 +1,143 @@
+// number_format_test.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Test corpus comparing numberFormat with snprintf("%g")                     *
+ ******************************************************************************
+ */
+
+// Preklad a spusteni z adresare tests:
+//   gcc -std=gnu99 -O2 -I.. number_format_test.c ../number_conversion.c -lm
+//   ./a.out [pocet nahodnych hodnot]
+
+#include "number_conversion.h"
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Vychozi pocet nahodnych hodnot
+#define RANDOM_VALUES 2000000
+
+static long mismatches = 0;
+
+// Generator xorshift64, vysledky jsou stejne na vsech platformach
+static uint64_t randomState = 88172645463325252ull;
+
+static uint64_t randomNext()
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return randomState;
+}
+
+/**
+ * Porovnani vystupu numberFormat se snprintf pro jednu hodnotu
+ * @param value Testovane cislo
+ */
+static void check(double value)
+{
+	char expected[64], actual[NUMBER_FORMAT_MAX_LENGTH];
+	int expectedLength = snprintf(expected, sizeof(expected), "%g", value);
+	int actualLength = numberFormat(value, actual);
+
+	if (expectedLength != actualLength || strcmp(expected, actual) != 0)
+	{
+		if (mismatches < 20)
+			fprintf(stderr, "%.17g: expected \"%s\", got \"%s\" (%d)\n", value, expected, actual, actualLength);
+		mismatches++;
+	}
+}
+
+/**
+ * Okrajove pripady - nuly, nekonecna, hranice zaokrouhleni a prepnuti
+ * na exponencialni tvar, cela cisla kolem 2^31 a 2^53, denormalizovana cisla
+ */
+static long checkEdgeCases()
+{
+	static const double values[] = {
+		0.0, -0.0, 1.0, -1.0, 0.5, 0.1, 0.2, 0.3, 1.5, 2.5, 10.0, 100.0,
+		999999.0, 999999.4, 999999.5, 1000000.0, 9999995.0, 123456.5, 1234567.0,
+		0.0001, 0.00001, 0.000099999949, 0.0000999995, 0.00009999951,
+		1e-5, 1e-4, 1e5, 1e6, 1e15, 1e16, 1e21, 1e22, 1e100, 1e300, 1e-300,
+		2147483647.0, 2147483648.0, 4294967295.0, 4294967296.0,
+		9007199254740991.0, 9007199254740992.0, 9007199254740993.0,
+		3.14159265358979, 2.718281828459045, 1.0 / 3.0, 2.0 / 3.0,
+		0.15, 0.25, 0.35, 1.25, 1.35, 0.125, 0.375, 1.0000005, 1.0000015,
+		DBL_MAX, DBL_MIN, DBL_EPSILON, 4.9406564584124654e-324, 2.2250738585072009e-308
+	};
+	long count = 0;
+
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+	{
+		check(values[i]);
+		check(-values[i]);
+		count += 2;
+	}
+
+	check(INFINITY);
+	check(-INFINITY);
+	check(NAN);
+	count += 3;
+
+	// Vsechny mocniny deseti a hodnoty tesne vedle nich
+	for (int exponent = -320; exponent <= 308; exponent++)
+	{
+		double value = pow(10.0, exponent);
+		check(value);
+		check(nextafter(value, 0.0));
+		check(nextafter(value, INFINITY));
+		count += 3;
+	}
+
+	// Cela cisla a poloviny v rozsahu primeho prevodu
+	for (int i = -100000; i <= 100000; i++)
+	{
+		check(i);
+		check(i + 0.5);
+		count += 2;
+	}
+
+	return count;
+}
+
+/**
+ * Nahodne hodnoty - libovolne bitove vzory, cisla s malo desetinnymi
+ * misty (nejcastejsi vystup programu) a cela cisla ruzne velikosti
+ * @param count Pocet hodnot kazdeho druhu
+ */
+static long checkRandom(long count)
+{
+	uint64_t bits;
+	double value;
+
+	for (long i = 0; i < count; i++)
+	{
+		bits = randomNext();
+		memcpy(&value, &bits, sizeof(value));
+		check(value);
+
+		value = (double) (int64_t) (randomNext() % 2000000000) / pow(10.0, (double) (randomNext() % 12));
+		check(value);
+		check(-value);
+
+		value = (double) (int64_t) (randomNext() >> (randomNext() % 64));
+		check(value);
+	}
+
+	return 4 * count;
+}
+
+int main(int argc, char *argv[])
+{
+	long count = argc > 1 ? atol(argv[1]) : RANDOM_VALUES;
+	long tested = checkEdgeCases() + checkRandom(count);
+
+	printf("%ld values, %ld mismatches\n", tested, mismatches);
+	return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
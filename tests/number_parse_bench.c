@@ -0,0 +1,144 @@
+// number_parse_bench.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Microbenchmark of numberParse against the generic conversion path         *
+ ******************************************************************************
+ */
+
+// Preklad a spusteni z adresare tests:
+//   gcc -std=gnu99 -O2 -I.. number_parse_bench.c ../number_conversion.c -lm
+//   ./a.out [pocet opakovani]
+// S definovanym NUMBER_BENCH_LIBSTRING se meri i stringToDouble, pak je
+// treba prilozit libstring.c a jeho zavislosti. Bez nej se obecna cesta
+// meri funkci strtod, na ktere stringToDouble stavi.
+// Pred merenim se vysledky numberParse porovnaji se strtod.
+
+#include "number_conversion.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef NUMBER_BENCH_LIBSTRING
+#include "libstring.h"
+#endif
+
+// Vychozi pocet opakovani kazdeho vstupu
+#define BENCH_ITERATIONS 2000000
+
+// Pocet nahodnych vstupu pro porovnani se strtod
+#define CHECK_VALUES 1000000
+
+// Vstupy typicke pro funkci numeric()
+static const char *inputs[] = {
+	"0", "7", "42", "12345.678", "3.14159", "  100", "\n-5", "1e10",
+	"0.000001", "123456789012345", "99.5abc", "  \t12.25"
+};
+
+// Generator xorshift64, vysledky jsou stejne na vsech platformach
+static uint64_t randomState = 88172645463325252ull;
+
+static uint64_t randomNext()
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return randomState;
+}
+
+static double now()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Porovnani numberParse se strtod na nahodnych vstupech. Pokud numberParse
+ * vstup prevede, musi byt vysledek bitove stejny jako u strtod
+ * @return Pocet rozdilu
+ */
+static long checkAgainstStrtod()
+{
+	static const char alphabet[] = "0123456789012345678901234567890123456789.. \t\n-+eE";
+	char buffer[32];
+	double expected, actual;
+	long mismatches = 0;
+
+	for (long i = 0; i < CHECK_VALUES; i++)
+	{
+		int length = randomNext() % 24;
+		for (int k = 0; k < length; k++)
+			buffer[k] = alphabet[randomNext() % (sizeof(alphabet) - 1)];
+		buffer[length] = '\0';
+
+		if (!numberParse(buffer, length, &actual))
+			continue;
+
+		expected = strtod(buffer, NULL);
+		if (memcmp(&expected, &actual, sizeof(double)) != 0)
+		{
+			if (mismatches < 20)
+				fprintf(stderr, "\"%s\": strtod %.17g, numberParse %.17g\n", buffer, expected, actual);
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+	long iterations = argc > 1 ? atol(argv[1]) : BENCH_ITERATIONS;
+	volatile double sink = 0.0;
+	double result, start, fast, generic;
+	long mismatches = checkAgainstStrtod();
+
+	printf("%-18s %12s %12s", "input", "numberParse", "strtod");
+#ifdef NUMBER_BENCH_LIBSTRING
+	printf(" %14s", "stringToDouble");
+#endif
+	printf("   (ns/call)\n");
+
+	for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++)
+	{
+		const char *input = inputs[i];
+		int length = strlen(input);
+
+		// Stejna cesta jako instructionNumeric, odmitnuty vstup jde do obecne funkce
+		start = now();
+		for (long k = 0; k < iterations; k++)
+		{
+			if (!numberParse(input, length, &result))
+				result = strtod(input, NULL);
+			sink += result;
+		}
+		fast = now() - start;
+
+		start = now();
+		for (long k = 0; k < iterations; k++)
+			sink += strtod(input, NULL);
+		generic = now() - start;
+
+		printf("%-18.*s %12.1f %12.1f", 18, input[0] == '\n' ? "\\n-5" : input,
+		       fast / iterations * 1e9, generic / iterations * 1e9);
+
+#ifdef NUMBER_BENCH_LIBSTRING
+		String *string = charToString(input);
+		start = now();
+		for (long k = 0; k < iterations; k++)
+		{
+			stringToDouble(string, &result);
+			sink += result;
+		}
+		printf(" %14.1f", (now() - start) / iterations * 1e9);
+		deallocString(string);
+#endif
+		printf("\n");
+	}
+
+	printf("%ld mismatches against strtod\n", mismatches);
+	return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,234 @@
+// source_scan_bench.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Pre-scanner throughput benchmark and result digest                         *
+ ******************************************************************************
+ */
+
+// Preklad a spusteni z adresare tests (oba preklady najednou spusti
+// source_scan_bench.sh, ktery porovna jejich otisky):
+//   gcc -std=gnu99 -O2 -I.. source_scan_bench.c ../source_scan.c
+//   gcc -std=gnu99 -O2 -I.. -DSOURCE_SCAN_SCALAR source_scan_bench.c ../source_scan.c
+//   ./a.out [zdrojovy soubor]
+// Program vypise propustnost pre-scanneru v MB/s a otisk vsech nalezenych
+// hlavicek a rozsahu funkci. Otisk musi byt stejny pro preklad s SSE2
+// i bez nej, jinak se varianty hledani znaku lisi.
+
+#include "source_scan.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Velikost generovaneho zdroje v bajtech
+#define BENCH_SOURCE_SIZE (32 * 1024 * 1024)
+
+// Pocet opakovani mereni
+#define BENCH_ROUNDS 5
+
+// Pocet nahodnych zdroju pro otisk
+#define DIGEST_SOURCES 200000
+
+// Generator xorshift64, vysledky jsou stejne na vsech platformach
+static uint64_t randomState = 88172645463325252ull;
+
+static uint64_t randomNext()
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return randomState;
+}
+
+static double now()
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// Pridani dat k otisku (64bitovy FNV-1a)
+static void digestAdd(uint64_t *digest, const void *data, size_t length)
+{
+	for (size_t i = 0; i < length; i++)
+	{
+		*digest ^= ((const unsigned char *) data)[i];
+		*digest *= 1099511628211ull;
+	}
+}
+
+/**
+ * Pruchod zdroje pre-scannerem, do otisku se zapisou vsechny hlavicky,
+ * rozsahy a vysledny chybovy kod
+ * @param  source Zdroj
+ * @param  ranges Urcovat i rozsah definice funkce
+ * @param  digest Otisk
+ * @return        Pocet nalezenych funkci
+ */
+static int scan(const tSource *source, bool ranges, uint64_t *digest)
+{
+	tSourceScan scan;
+	tFunctionHeader header;
+	bool found;
+	ecode error;
+	int count = 0;
+
+	sourceScanInit(&scan, source);
+	while ((error = sourceNextFunction(&scan, &header, &found)) == ERR_OK && found)
+	{
+		count++;
+		digestAdd(digest, header.name, header.length);
+		digestAdd(digest, &header.paramsCount, sizeof(header.paramsCount));
+		digestAdd(digest, &header.begin, sizeof(header.begin));
+		if (!ranges)
+			continue;
+
+		if ((error = sourceFunctionRange(&scan, &header)) != ERR_OK)
+			break;
+		digestAdd(digest, &header.line, sizeof(header.line));
+		digestAdd(digest, &header.end, sizeof(header.end));
+		digestAdd(digest, &header.endLine, sizeof(header.endLine));
+	}
+	digestAdd(digest, &error, sizeof(error));
+	return count;
+}
+
+/**
+ * Otisk nahodnych zdroju poskladanych z kousku, na kterych se pre-scanner
+ * rozhoduje (klicova slova, retezce, komentare, escape sekvence)
+ * @return Otisk
+ */
+static uint64_t randomDigest()
+{
+	static const char *pieces[] = {
+		"function", " ", "f", "(", ")", ",", "a", "b1", "\"", "\\", "/", "*", "\n", "x",
+		"functionx", "if", "while", "end", "\t", "/*", "*/", "//", "fun", "0123456789abcdef"
+	};
+	const int count = sizeof(pieces) / sizeof(pieces[0]);
+	uint64_t digest = 14695981039346656037ull;
+	char buffer[2048];
+	tSource source;
+
+	for (int i = 0; i < DIGEST_SOURCES; i++)
+	{
+		size_t length = 0;
+		int parts = randomNext() % 60;
+		for (int k = 0; k < parts; k++)
+		{
+			const char *piece = pieces[randomNext() % count];
+			memcpy(buffer + length, piece, strlen(piece));
+			length += strlen(piece);
+		}
+
+		// Zdroj v presne velkem bufferu, cteni za konec odhali sanitizer
+		char *data = malloc(length + 1);
+		memcpy(data, buffer, length);
+		sourceFromBuffer(data, length, &source);
+		scan(&source, false, &digest);
+		scan(&source, true, &digest);
+		free(data);
+	}
+	return digest;
+}
+
+/**
+ * Vygenerovani zdroje podobneho skutecnym programum - funkce s komentari,
+ * retezci, podminkami a cykly
+ * @param  size   Pozadovana velikost
+ * @param  length Ukazatel pro ulozeni skutecne delky
+ * @return        Zdroj
+ */
+static char *generateSource(size_t size, size_t *length)
+{
+	char *data = malloc(size + 512);
+	size_t used = 0;
+	int function = 0;
+
+	while (used < size)
+	{
+		used += sprintf(data + used,
+			"// Funkce cislo %d, vypocet a vypis vysledku\n"
+			"function f%d(a, b, c)\n"
+			"  /* mezivysledek */ x = a * b + c\n"
+			"  if x > 100\n"
+			"    s = \"velke cislo: \\\"%d\\\"\\n\"\n"
+			"  else\n"
+			"    s = \"male cislo\"\n"
+			"  end\n"
+			"  while x > 0\n"
+			"    x = x - 1 // odecteni\n"
+			"  end\n"
+			"  return s\n"
+			"end\n\n", function, function, function);
+		function++;
+	}
+	used += sprintf(data + used, "x = f0(1, 2, 3)\nprint(x)\n");
+
+	*length = used;
+	return data;
+}
+
+int main(int argc, char *argv[])
+{
+	tSource source;
+	FILE *file = NULL;
+	uint64_t digest;
+	double start, headers, ranges;
+	int count = 0;
+
+	if (argc > 1)
+	{
+		file = fopen(argv[1], "r");
+		if (file == NULL || sourceLoad(file, &source) != ERR_OK)
+		{
+			fprintf(stderr, "cannot load %s\n", argv[1]);
+			return EXIT_FAILURE;
+		}
+	}
+	else
+	{
+		size_t length;
+		char *data = generateSource(BENCH_SOURCE_SIZE, &length);
+		sourceFromBuffer(data, length, &source);
+	}
+
+	// -------------- Mereni ----------------------------------------------------
+	start = now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		digest = 14695981039346656037ull;
+		count = scan(&source, false, &digest);
+	}
+	headers = now() - start;
+
+	start = now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		digest = 14695981039346656037ull;
+		scan(&source, true, &digest);
+	}
+	ranges = now() - start;
+
+#ifdef SOURCE_SCAN_SCALAR
+	printf("scalar: ");
+#else
+	printf("default: ");
+#endif
+	printf("%zu bytes, %d functions\n", source.length, count);
+	printf("headers:          %8.0f MB/s\n", BENCH_ROUNDS * source.length / 1e6 / headers);
+	printf("headers + ranges: %8.0f MB/s\n", BENCH_ROUNDS * source.length / 1e6 / ranges);
+	printf("digest %016llx %016llx\n", (unsigned long long) digest, (unsigned long long) randomDigest());
+
+	if (file != NULL)
+	{
+		sourceFree(&source);
+		fclose(file);
+	}
+	else
+		free(source.data);
+	return EXIT_SUCCESS;
+}
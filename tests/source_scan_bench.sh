@@ -0,0 +1,19 @@
+#!/bin/sh
+# Benchmark pre-scanneru s SSE2 a bez nej, otisky vysledku se musi shodovat
+# Pouziti: [CC=...] [CFLAGS=...] ./source_scan_bench.sh [zdrojovy soubor]
+
+cd "$(dirname "$0")" || exit 1
+CC=${CC:-gcc}
+TMP=${TMPDIR:-/tmp}
+
+$CC -std=gnu99 -O2 $CFLAGS -I.. source_scan_bench.c ../source_scan.c -o "$TMP/source_scan_bench" || exit 1
+$CC -std=gnu99 -O2 $CFLAGS -I.. -DSOURCE_SCAN_SCALAR source_scan_bench.c ../source_scan.c -o "$TMP/source_scan_bench_scalar" || exit 1
+
+"$TMP/source_scan_bench" "$@" | tee "$TMP/source_scan_bench.out" || exit 1
+"$TMP/source_scan_bench_scalar" "$@" | tee "$TMP/source_scan_bench_scalar.out" || exit 1
+
+if [ "$(grep digest "$TMP/source_scan_bench.out")" != "$(grep digest "$TMP/source_scan_bench_scalar.out")" ]; then
+	echo "digest mismatch between SSE2 and scalar scanner" >&2
+	exit 1
+fi
+echo "digests match"
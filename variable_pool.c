@@ -0,0 +1,160 @@
+// variable_pool.c
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Size-class pool allocator for variable headers and scalar payloads        *
+ ******************************************************************************
+ */
+#include "variable_pool.h"
+#include "errnum.h"
+#include <stdlib.h>
+
+// Volne bloky a statistiky patri vlaknu, ktere blok uvolnilo
+typedef struct
+{
+	void *freeList[VARIABLE_POOL_CLASSES];	// Seznamy volnych bloku trid
+	tVariablePoolStats stats;				// Statistiky vlakna
+} tVariablePoolCache;
+
+tVariablePool variablePool = { NULL, 0, 0, { 0 } };
+void (*variablePoolStatsHook)(const tVariablePoolStats *stats) = NULL;
+
+static __thread tVariablePoolCache poolCache;
+
+#ifdef VARIABLE_POOL_STATS
+#define poolStat(statement) (statement)
+#else
+#define poolStat(statement) ((void) 0)
+#endif
+
+/**
+ * Urceni velikostni tridy pro pozadovanou velikost
+ * @param  size Velikost bloku
+ * @return      Index tridy (blok tridy i ma 8 << i bajtu)
+ */
+static int sizeClass(size_t size)
+{
+	int index = 0;
+	size_t classBytes = 8;
+
+	while (classBytes < size)
+	{
+		classBytes <<= 1;
+		index++;
+	}
+	return index;
+}
+
+// Inicializace poolu
+ecode variablePoolInit(size_t size)
+{
+#ifndef VARIABLE_POOL_USE_MALLOC
+	// Cast kazde tridy zarovnana na nejvetsi blok
+	size_t classSize = (size / VARIABLE_POOL_CLASSES) & ~((size_t) VARIABLE_POOL_MAX_SIZE - 1);
+
+	variablePool.data = malloc(classSize * VARIABLE_POOL_CLASSES);
+	if (variablePool.data == NULL)
+		return ERR_MEMORY;
+
+	variablePool.size = classSize * VARIABLE_POOL_CLASSES;
+	variablePool.classSize = classSize;
+	for (int i = 0; i < VARIABLE_POOL_CLASSES; i++)
+		variablePool.used[i] = 0;
+#else
+	(void) size;
+#endif
+	return ERR_OK;
+}
+
+// Alokace bloku
+void *variablePoolAlloc(size_t size)
+{
+#ifdef VARIABLE_POOL_USE_MALLOC
+	poolStat(poolCache.stats.allocations++);
+	poolStat(poolCache.stats.fallbacks++);
+	return malloc(size);
+#else
+	int index;
+	size_t offset;
+	void *block;
+
+	poolStat(poolCache.stats.allocations++);
+
+	if (size > VARIABLE_POOL_MAX_SIZE || variablePool.data == NULL)
+	{
+		poolStat(poolCache.stats.fallbacks++);
+		return malloc(size);
+	}
+
+	index = sizeClass(size);
+
+	// -------------- Blok ze seznamu volnych bloku vlakna ----------------------
+	block = poolCache.freeList[index];
+	if (block != NULL)
+	{
+		poolCache.freeList[index] = *((void **) block);
+		poolStat(poolCache.stats.reused++);
+		poolStat(poolCache.stats.bytesInUse += (size_t) 8 << index);
+		return block;
+	}
+
+	// -------------- Novy blok z casti tridy (sdilene mezi vlakny) -------------
+	offset = __sync_fetch_and_add(&variablePool.used[index], (size_t) 8 << index);
+	if (offset + ((size_t) 8 << index) > variablePool.classSize)
+	{
+		poolStat(poolCache.stats.fallbacks++);
+		return malloc(size);
+	}
+
+	poolStat(poolCache.stats.bytesInUse += (size_t) 8 << index);
+	return variablePool.data + index * variablePool.classSize + offset;
+#endif
+}
+
+// Uvolneni bloku
+void variablePoolRelease(void *pointer)
+{
+	int index;
+
+	if (pointer == NULL)
+		return;
+
+	poolStat(poolCache.stats.releases++);
+
+	if (!variablePoolContains(pointer))
+	{
+		free(pointer);
+		return;
+	}
+
+	// Trida se urci podle casti oblasti, ve ktere blok lezi
+	index = ((char *) pointer - variablePool.data) / variablePool.classSize;
+	poolStat(poolCache.stats.bytesInUse -= (size_t) 8 << index);
+
+	*((void **) pointer) = poolCache.freeList[index];
+	poolCache.freeList[index] = pointer;
+}
+
+// Statistiky poolu
+void variablePoolGetStats(tVariablePoolStats *stats)
+{
+	*stats = poolCache.stats;
+}
+
+// Uvolneni poolu
+void variablePoolDispose()
+{
+	if (variablePoolStatsHook != NULL)
+		variablePoolStatsHook(&poolCache.stats);
+
+	free(variablePool.data);
+	variablePool.data = NULL;
+	variablePool.size = variablePool.classSize = 0;
+	for (int i = 0; i < VARIABLE_POOL_CLASSES; i++)
+	{
+		variablePool.used[i] = 0;
+		poolCache.freeList[i] = NULL;
+	}
+}
@@ -0,0 +1,91 @@
+// variable_pool.h
+/******************************************************************************
+ * Implementace interpretu imperativniho jazyka IFJ12                         *
+ * Autori:                                                                    *
+ *          Tomas Nestrojil (xnestr03)                                        *
+ *                                                                            *
+ * Size-class pool allocator for variable headers and scalar payloads        *
+ ******************************************************************************
+ */
+
+#ifndef VARIABLE_POOL_H
+#define VARIABLE_POOL_H
+
+#include <stddef.h>
+#include "errnum.h"
+
+// Velikost oblasti poolu, rozdeli se rovnym dilem mezi velikostni tridy
+#ifndef VARIABLE_POOL_SIZE
+#define VARIABLE_POOL_SIZE (4 * 1024 * 1024)
+#endif
+
+// Velikostni tridy 8, 16, 32 a 64 bajtu
+#define VARIABLE_POOL_CLASSES 4
+#define VARIABLE_POOL_MAX_SIZE 64
+
+// Statistiky poolu pro aktualni vlakno
+typedef struct
+{
+	unsigned long allocations;	// Pocet alokaci
+	unsigned long releases;		// Pocet uvolneni
+	unsigned long fallbacks;	// Alokace predane funkci malloc (plny pool, velky blok)
+	unsigned long reused;		// Alokace obslouzene ze seznamu volnych bloku
+	size_t bytesInUse;			// Bajty aktualne pouzite v poolu
+} tVariablePoolStats;
+
+// Oblast poolu - souvisly blok, aby slo o ukazateli rozhodnout porovnanim
+typedef struct
+{
+	char *data;							// Zacatek oblasti
+	size_t size;						// Velikost oblasti
+	size_t classSize;					// Velikost casti pro jednu tridu
+	size_t used[VARIABLE_POOL_CLASSES];	// Pouzita cast kazde tridy
+} tVariablePool;
+
+extern tVariablePool variablePool;
+
+#ifdef VARIABLE_POOL_USE_MALLOC
+// Pool vypnut pro porovnani s funkci malloc
+#define variablePoolContains(pointer) 0
+#else
+// Zjisti, zda blok pochazi z poolu
+#define variablePoolContains(pointer) ((char *) (pointer) >= variablePool.data && \
+                                       (char *) (pointer) < variablePool.data + variablePool.size)
+#endif
+
+// Funkce volana pri uvolneni poolu se statistikami, pokud je nastavena
+extern void (*variablePoolStatsHook)(const tVariablePoolStats *stats);
+
+/**
+ * Inicializace poolu
+ * @param  size Velikost oblasti poolu v bajtech
+ * @return      ERR_OK pokud je vse v poradku, jinak ERR_MEMORY
+ */
+ecode variablePoolInit(size_t size);
+
+/**
+ * Alokace bloku z nejmensi vyhovujici velikostni tridy. Vetsi bloky
+ * a alokace pri plnem poolu obslouzi malloc
+ * @param  size Velikost bloku v bajtech
+ * @return      Ukazatel na blok nebo NULL pri nedostatku pameti
+ */
+void *variablePoolAlloc(size_t size);
+
+/**
+ * Uvolneni bloku, blok mimo pool se uvolni funkci free
+ * @param pointer Ukazatel na blok nebo NULL
+ */
+void variablePoolRelease(void *pointer);
+
+/**
+ * Ziskani statistik poolu pro aktualni vlakno
+ * @param stats Ukazatel pro ulozeni statistik
+ */
+void variablePoolGetStats(tVariablePoolStats *stats);
+
+/**
+ * Uvolneni poolu
+ */
+void variablePoolDispose();
+
+#endif // VARIABLE_POOL_H